@@ -0,0 +1,281 @@
+/*
+  +----------------------------------------------------------------------+
+  | PHP Version 7                                                        |
+  +----------------------------------------------------------------------+
+  | Copyright (c) 1997-2018 The PHP Group                                |
+  +----------------------------------------------------------------------+
+  | This source file is subject to version 3.01 of the PHP license,      |
+  | that is bundled with this package in the file LICENSE, and is        |
+  | available through the world-wide-web at the following url:           |
+  | http://www.php.net/license/3_01.txt                                  |
+  | If you did not receive a copy of the PHP license and are unable to   |
+  | obtain it through the world-wide-web, please send a note to          |
+  | license@php.net so we can mail you a copy immediately.               |
+  +----------------------------------------------------------------------+
+  | Author: Youlin Feng <fengyoulin@php7th.com>                          |
+  +----------------------------------------------------------------------+
+*/
+
+/* $Id$ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "php.h"
+#include "php_ini.h"
+#include "ext/standard/info.h"
+#include "php_zendump.h"
+#include "zend_smart_str.h"
+#include "zend_closures.h"
+
+ZEND_EXTERN_MODULE_GLOBALS(zendump)
+
+#if PHP_API_VERSION >= 20160303
+# define BACKTRACE_CLOSURE_OBJECT(func) ZEND_CLOSURE_OBJECT(func)
+#else
+# define BACKTRACE_CLOSURE_OBJECT(func) ((zend_object*)(func)->op_array.prototype)
+#endif
+
+/* Functions and classes live until the end of the request, so most frames
+   only keep pointers. The code of included and eval'd files and the
+   trampolines of __call are freed as soon as they return, so for those the
+   names are referenced instead, and closures are kept alive by their
+   object. */
+typedef struct _zendump_backtrace_frame {
+	zend_function     *func;
+	zend_string       *name;
+	zend_string       *filename;
+	zend_class_entry  *scope;
+	zend_class_entry  *object_ce;
+	zend_object       *closure;
+	zend_execute_data *frame;
+	zval              *args;
+	uint32_t          num_args;
+	uint32_t          lineno;
+} zendump_backtrace_frame;
+
+typedef struct _zendump_backtrace {
+	uint32_t  first;
+	uint32_t  count;
+	zend_bool formatted;
+} zendump_backtrace;
+
+static void zendump_backtrace_frame_release(zendump_backtrace_frame *frame)
+{
+	uint32_t idx;
+
+	if(frame->name) {
+		zend_string_release(frame->name);
+	}
+	if(frame->filename) {
+		zend_string_release(frame->filename);
+	}
+	if(frame->closure) {
+		OBJ_RELEASE(frame->closure);
+	}
+	if(frame->args) {
+		for(idx = 0; idx < frame->num_args; ++idx) {
+			zval_ptr_dtor(frame->args + idx);
+		}
+		efree(frame->args);
+	}
+}
+
+static void zendump_backtrace_args(zendump_backtrace_frame *frame, zend_execute_data *ex)
+{
+	zend_function *func = ex->func;
+	uint32_t idx, count = ZEND_CALL_NUM_ARGS(ex);
+	zval *val;
+
+	frame->num_args = count;
+	if(!count) {
+		return;
+	}
+	frame->args = safe_emalloc(count, sizeof(zval), 0);
+	for(idx = 0; idx < count; ++idx) {
+		if(!ZEND_USER_CODE(func->type)) {
+			val = ZEND_CALL_ARG(ex, idx + 1);
+		} else if(idx < func->op_array.num_args) {
+			val = ZEND_CALL_VAR_NUM(ex, idx);
+		} else {
+			val = ZEND_CALL_VAR_NUM(ex, func->op_array.last_var + func->op_array.T + idx - func->op_array.num_args);
+		}
+		ZVAL_COPY(frame->args + idx, val);
+	}
+}
+
+zend_long zendump_backtrace_capture(zend_execute_data *ex, zend_long limit, zend_bool with_args)
+{
+	zendump_backtrace_frame *frame;
+	zendump_backtrace *capture;
+	zend_function *func;
+	uint32_t first = ZENDUMP_G(backtrace_frames_used);
+
+	if(ZENDUMP_G(backtrace_buffer_size) <= 0) {
+		php_error_docref(NULL, E_WARNING, "zendump.backtrace_buffer_size is 0");
+		return -1;
+	}
+	if(!ZENDUMP_G(backtrace_frames)) {
+		ZENDUMP_G(backtrace_frames) = safe_emalloc(ZENDUMP_G(backtrace_buffer_size), sizeof(zendump_backtrace_frame), 0);
+	}
+
+	for(; ex && (limit <= 0 || ZENDUMP_G(backtrace_frames_used) - first < limit); ex = ex->prev_execute_data) {
+		func = ex->func;
+		if(!func) {
+			continue;
+		}
+		if(ZENDUMP_G(backtrace_frames_used) == ZENDUMP_G(backtrace_buffer_size)) {
+			while(ZENDUMP_G(backtrace_frames_used) > first) {
+				zendump_backtrace_frame_release(ZENDUMP_G(backtrace_frames) + --ZENDUMP_G(backtrace_frames_used));
+			}
+			php_error_docref(NULL, E_WARNING, "The backtrace buffer is full, raise zendump.backtrace_buffer_size");
+			return -1;
+		}
+		frame = ZENDUMP_G(backtrace_frames) + ZENDUMP_G(backtrace_frames_used)++;
+		memset(frame, 0, sizeof(zendump_backtrace_frame));
+		frame->frame = ex;
+		frame->scope = func->common.scope;
+		if(Z_TYPE(ex->This) == IS_OBJECT) {
+			frame->object_ce = Z_OBJCE(ex->This);
+		}
+		if(ZEND_USER_CODE(func->type)) {
+			frame->lineno = ex->opline ? ex->opline->lineno : 0;
+		}
+		if(ZEND_USER_CODE(func->type) && !func->common.function_name) {
+			frame->filename = zend_string_copy(func->op_array.filename);
+		} else if(func->common.fn_flags & ZEND_ACC_CALL_VIA_TRAMPOLINE) {
+			frame->name = zend_string_copy(func->common.function_name);
+		} else {
+			frame->func = func;
+			if(ZEND_CALL_INFO(ex) & ZEND_CALL_CLOSURE) {
+				frame->closure = BACKTRACE_CLOSURE_OBJECT(func);
+				GC_REFCOUNT(frame->closure)++;
+			}
+		}
+		if(with_args) {
+			zendump_backtrace_args(frame, ex);
+		}
+	}
+
+	if(ZENDUMP_G(backtrace_count) == ZENDUMP_G(backtrace_size)) {
+		ZENDUMP_G(backtrace_size) = ZENDUMP_G(backtrace_size) ? ZENDUMP_G(backtrace_size) * 2 : 64;
+		ZENDUMP_G(backtraces) = safe_erealloc(ZENDUMP_G(backtraces), ZENDUMP_G(backtrace_size), sizeof(zendump_backtrace), 0);
+	}
+	capture = ZENDUMP_G(backtraces) + ZENDUMP_G(backtrace_count);
+	capture->first = first;
+	capture->count = ZENDUMP_G(backtrace_frames_used) - first;
+	capture->formatted = 0;
+	return ZENDUMP_G(backtrace_count)++;
+}
+
+static void zendump_backtrace_frame_append(smart_str *buf, zendump_backtrace_frame *frame, uint32_t depth)
+{
+	uint32_t idx;
+
+	smart_str_appendc(buf, '#');
+	smart_str_append_unsigned(buf, depth);
+	smart_str_appendc(buf, ' ');
+	if(frame->object_ce) {
+		smart_str_append(buf, frame->object_ce->name);
+		smart_str_appends(buf, "->");
+	} else if(frame->scope) {
+		smart_str_append(buf, frame->scope->name);
+		smart_str_appends(buf, "::");
+	}
+	if(frame->func) {
+		smart_str_append(buf, frame->func->common.function_name);
+	} else if(frame->name) {
+		smart_str_append(buf, frame->name);
+	} else {
+		smart_str_appends(buf, "{main}");
+	}
+	smart_str_appendc(buf, '(');
+	for(idx = 0; idx < frame->num_args; ++idx) {
+		if(idx) {
+			smart_str_appends(buf, ", ");
+		}
+		zendump_zval_summary_append(buf, frame->args + idx);
+	}
+	smart_str_appendc(buf, ')');
+	if(frame->filename || (frame->func && ZEND_USER_CODE(frame->func->type))) {
+		smart_str_appendc(buf, ' ');
+		smart_str_append(buf, frame->filename ? frame->filename : frame->func->op_array.filename);
+		smart_str_appendc(buf, ':');
+		smart_str_append_unsigned(buf, frame->lineno);
+	}
+	smart_str_appendc(buf, '\n');
+}
+
+zend_string *zendump_backtrace_format(zend_long handle)
+{
+	zendump_backtrace *capture;
+	smart_str buf = {0};
+	uint32_t idx;
+
+	if(handle < 0 || handle >= ZENDUMP_G(backtrace_count)) {
+		return NULL;
+	}
+	capture = ZENDUMP_G(backtraces) + handle;
+	capture->formatted = 1;
+	for(idx = 0; idx < capture->count; ++idx) {
+		zendump_backtrace_frame_append(&buf, ZENDUMP_G(backtrace_frames) + capture->first + idx, idx);
+	}
+	if(!buf.s) {
+		return ZSTR_EMPTY_ALLOC();
+	}
+	smart_str_0(&buf);
+	return buf.s;
+}
+
+/* Captures nobody asked for during the request are formatted into the
+   backtrace log, if one is configured, when the request ends. */
+static void zendump_backtrace_flush()
+{
+	php_stream *stream = NULL;
+	zend_string *text;
+	uint32_t idx;
+
+	for(idx = 0; idx < ZENDUMP_G(backtrace_count); ++idx) {
+		if(ZENDUMP_G(backtraces)[idx].formatted) {
+			continue;
+		}
+		if(!stream) {
+			stream = php_stream_open_wrapper(ZENDUMP_G(backtrace_log), "ab", REPORT_ERRORS, NULL);
+			if(!stream) {
+				return;
+			}
+		}
+		text = zendump_backtrace_format(idx);
+		php_stream_printf(stream, "backtrace(%u,%u): {\n", idx, ZENDUMP_G(backtraces)[idx].count);
+		php_stream_write(stream, ZSTR_VAL(text), ZSTR_LEN(text));
+		php_stream_write(stream, "}\n", sizeof("}\n") - 1);
+		zend_string_release(text);
+	}
+	if(stream) {
+		php_stream_close(stream);
+	}
+}
+
+void zendump_backtrace_reset()
+{
+	uint32_t idx;
+
+	if(ZENDUMP_G(backtrace_log) && *ZENDUMP_G(backtrace_log)) {
+		zendump_backtrace_flush();
+	}
+	for(idx = 0; idx < ZENDUMP_G(backtrace_frames_used); ++idx) {
+		zendump_backtrace_frame_release(ZENDUMP_G(backtrace_frames) + idx);
+	}
+	if(ZENDUMP_G(backtrace_frames)) {
+		efree(ZENDUMP_G(backtrace_frames));
+		ZENDUMP_G(backtrace_frames) = NULL;
+	}
+	if(ZENDUMP_G(backtraces)) {
+		efree(ZENDUMP_G(backtraces));
+		ZENDUMP_G(backtraces) = NULL;
+	}
+	ZENDUMP_G(backtrace_frames_used) = 0;
+	ZENDUMP_G(backtrace_count) = 0;
+	ZENDUMP_G(backtrace_size) = 0;
+}
@@ -0,0 +1,37 @@
+<?php
+/*
+ * Call-heavy workload for benchmarks/run.php: measures the time of a user
+ * function call, minus the cost of the surrounding loop, so the result is
+ * the per-call overhead added by the hooks on zend_execute_ex.
+ *
+ * Usage: php benchmarks/calls.php [calls]
+ */
+
+function leaf($a, $b) {
+	return $a + $b;
+}
+
+function middle($a) {
+	return leaf($a, 1) + leaf($a, 2);
+}
+
+$calls = isset($argv[1]) ? max(1, (int)$argv[1]) : 1000000;
+
+$start = microtime(true);
+for ($i = 0; $i < $calls; $i += 3) {
+	$r = $i + 1;
+}
+$loop = microtime(true) - $start;
+
+$start = microtime(true);
+for ($i = 0; $i < $calls; $i += 3) {
+	$r = middle($i);
+}
+$elapsed = microtime(true) - $start;
+
+echo json_encode([
+	'case'  => 'user_calls',
+	'calls' => $calls,
+	'value' => max(0, $elapsed - $loop) * 1e9 / $calls,
+	'unit'  => 'ns/call',
+]), "\n";
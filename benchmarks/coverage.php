@@ -0,0 +1,146 @@
+<?php
+/*
+ * Compares the overhead of zendump, Xdebug and PCOV line coverage on a set
+ * of standalone workloads that make no zendump calls, so every driver runs
+ * exactly the same code. Every driver runs each script in a separate
+ * process with coverage collected from the first to the last line.
+ *
+ * Usage: php benchmarks/coverage.php [rounds]
+ *
+ * The extensions are loaded with the settings below, override them with the
+ * ZENDUMP_BENCH_ZENDUMP, ZENDUMP_BENCH_XDEBUG and ZENDUMP_BENCH_PCOV
+ * environment variables when they are not found by name.
+ */
+
+$rounds = isset($argv[1]) ? max(1, (int)$argv[1]) : 5;
+$drivers = [
+	'none'    => '',
+	'zendump' => getenv('ZENDUMP_BENCH_ZENDUMP') ?: '-d extension=zendump -d zendump.enable_coverage=1',
+	'xdebug'  => getenv('ZENDUMP_BENCH_XDEBUG') ?: '-d zend_extension=xdebug -d xdebug.mode=coverage -d xdebug.coverage_enable=1',
+	'pcov'    => getenv('ZENDUMP_BENCH_PCOV') ?: '-d extension=pcov -d pcov.enabled=1 -d pcov.directory=/',
+];
+$probes = [
+	'zendump' => 'zendump',
+	'xdebug'  => 'xdebug',
+	'pcov'    => 'pcov',
+];
+
+$dir = sys_get_temp_dir() . '/zendump-coverage-' . getmypid();
+@mkdir($dir);
+$prepend = $dir . '/prepend.php';
+file_put_contents($prepend, <<<'PHP'
+<?php
+switch (getenv('ZENDUMP_BENCH_DRIVER')) {
+	case 'zendump':
+		zendump_coverage_start();
+		register_shutdown_function(function () { zendump_coverage_stop(); });
+		break;
+	case 'xdebug':
+		xdebug_start_code_coverage(XDEBUG_CC_UNUSED);
+		register_shutdown_function(function () { xdebug_get_code_coverage(); xdebug_stop_code_coverage(); });
+		break;
+	case 'pcov':
+		\pcov\start();
+		register_shutdown_function(function () { \pcov\stop(); \pcov\collect(); });
+		break;
+}
+PHP
+);
+
+$workloads = [
+	'calls' => <<<'PHP'
+<?php
+function leaf($a, $b) { return $a + $b; }
+function middle($a) { return leaf($a, 1) * leaf($a, 2); }
+$sum = 0;
+for ($i = 0; $i < 300000; ++$i) {
+	$sum += middle($i) % 7;
+}
+PHP
+	,
+	'objects' => <<<'PHP'
+<?php
+class Point {
+	private $x, $y;
+	public function __construct($x, $y) { $this->x = $x; $this->y = $y; }
+	public function add(Point $other) { return new Point($this->x + $other->x, $this->y + $other->y); }
+	public function length() { return sqrt($this->x * $this->x + $this->y * $this->y); }
+}
+$p = new Point(0, 0);
+for ($i = 0; $i < 200000; ++$i) {
+	$p = $p->add(new Point($i % 3, $i % 5));
+	if ($p->length() > 1000) {
+		$p = new Point(0, 0);
+	}
+}
+PHP
+	,
+	'strings' => <<<'PHP'
+<?php
+$words = [];
+for ($i = 0; $i < 100000; ++$i) {
+	$word = str_pad(dechex($i), 8, '0', STR_PAD_LEFT);
+	if (isset($words[$word[0]])) {
+		$words[$word[0]] .= substr($word, 4);
+	} else {
+		$words[$word[0]] = $word;
+	}
+}
+ksort($words);
+$joined = implode(',', $words);
+PHP
+	,
+	'arrays' => <<<'PHP'
+<?php
+$rows = [];
+for ($i = 0; $i < 50000; ++$i) {
+	$rows[] = ['id' => $i, 'group' => $i % 17, 'value' => $i * 3];
+}
+$groups = [];
+foreach ($rows as $row) {
+	$groups[$row['group']][] = $row['value'];
+}
+$sums = array_map('array_sum', $groups);
+usort($rows, function ($a, $b) { return $b['value'] - $a['value']; });
+PHP
+	,
+];
+
+$scripts = [];
+foreach ($workloads as $name => $code) {
+	$script = $dir . '/' . $name . '.php';
+	file_put_contents($script, $code);
+	$scripts[] = $script;
+}
+
+$results = [];
+foreach ($drivers as $driver => $args) {
+	if (isset($probes[$driver])) {
+		exec(PHP_BINARY . " $args -r " . escapeshellarg("exit(extension_loaded('{$probes[$driver]}') ? 0 : 1);") . ' 2>/dev/null', $output, $status);
+		if ($status !== 0) {
+			printf("%-10s not available\n", $driver);
+			continue;
+		}
+	}
+	$best = INF;
+	for ($round = 0; $round < $rounds; ++$round) {
+		$start = microtime(true);
+		foreach ($scripts as $script) {
+			exec('ZENDUMP_BENCH_DRIVER=' . $driver . ' ' . PHP_BINARY . " $args -d auto_prepend_file=" . escapeshellarg($prepend) . ' ' . escapeshellarg($script) . ' >/dev/null 2>&1', $output, $status);
+			if ($status !== 0) {
+				printf("%-10s failed on %s with status %d\n", $driver, basename($script), $status);
+				continue 3;
+			}
+		}
+		$best = min($best, microtime(true) - $start);
+	}
+	$results[$driver] = $best;
+	printf("%-10s %8.3fs", $driver, $best);
+	if (isset($results['none']) && $driver !== 'none') {
+		printf("  %+.1f%%", ($best / $results['none'] - 1) * 100);
+	}
+	echo "\n";
+}
+
+array_map('unlink', glob($dir . '/*'));
+rmdir($dir);
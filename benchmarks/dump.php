@@ -0,0 +1,57 @@
+<?php
+/*
+ * Dumper workload for benchmarks/run.php: times zendump() and var_dump() on
+ * large packed, hashed, string-heavy and object-heavy structures with the
+ * output captured by an output buffer, so no terminal I/O is measured.
+ *
+ * Usage: php benchmarks/dump.php [elements]
+ */
+
+class BenchNode {
+	public $id;
+	public $name;
+	public $score;
+	protected $tags;
+	private $parent;
+
+	public function __construct($id, $parent) {
+		$this->id = $id;
+		$this->name = 'node' . $id;
+		$this->score = $id / 7;
+		$this->tags = ['a', 'b'];
+		$this->parent = $parent;
+	}
+}
+
+$elements = isset($argv[1]) ? max(1, (int)$argv[1]) : 20000;
+
+$structures = [
+	'packed'  => range(1, $elements),
+	'hashed'  => [],
+	'strings' => [],
+	'objects' => [],
+];
+$root = new BenchNode(-1, null);
+for ($i = 0; $i < $elements; ++$i) {
+	$structures['hashed']['key' . $i] = $i;
+	$structures['strings'][] = str_repeat(chr(97 + $i % 26), 100) . $i;
+	$structures['objects'][] = new BenchNode($i, $root);
+}
+
+foreach ($structures as $name => $value) {
+	foreach (['zendump', 'var_dump'] as $dumper) {
+		ob_start();
+		$start = microtime(true);
+		$dumper($value);
+		$elapsed = microtime(true) - $start;
+		$bytes = ob_get_length();
+		ob_end_clean();
+		echo json_encode([
+			'case'     => $name . '/' . $dumper,
+			'elements' => $elements,
+			'bytes'    => $bytes,
+			'value'    => $elapsed * 1e3,
+			'unit'     => 'ms',
+		]), "\n";
+	}
+}
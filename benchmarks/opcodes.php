@@ -0,0 +1,34 @@
+<?php
+/*
+ * Disassembler workload for benchmarks/run.php: generates a function with a
+ * large op_array and times zendump_opcodes() on it.
+ *
+ * Usage: php benchmarks/opcodes.php [statements]
+ */
+
+$statements = isset($argv[1]) ? max(1, (int)$argv[1]) : 5000;
+
+$body = '';
+for ($i = 0; $i < $statements; ++$i) {
+	$body .= "\$v{$i} = \$a + {$i};\nif (\$v{$i} > \$b) { \$b = strlen('s{$i}') + \$v{$i}; }\n";
+}
+$file = tempnam(sys_get_temp_dir(), 'zendump-opcodes');
+file_put_contents($file, "<?php\nfunction big(\$dump, \$a = 0, \$b = 0) {\nif (\$dump) { zendump_opcodes(); return; }\n{$body}return \$b;\n}\n");
+include $file;
+unlink($file);
+
+ob_start();
+$start = microtime(true);
+big(true);
+$elapsed = microtime(true) - $start;
+$bytes = ob_get_length();
+ob_end_clean();
+
+$function = new ReflectionFunction('big');
+echo json_encode([
+	'case'  => 'zendump_opcodes',
+	'lines' => $function->getEndLine() - $function->getStartLine() + 1,
+	'bytes' => $bytes,
+	'value' => $elapsed * 1e3,
+	'unit'  => 'ms',
+]), "\n";
@@ -0,0 +1,77 @@
+<?php
+/*
+ * Runs the zendump benchmarks and prints one JSON object per result line,
+ * keyed by suite, case and mode, so the output can be stored and compared
+ * across commits. Every measurement runs in a fresh process and the best of
+ * the rounds is reported.
+ *
+ * Usage: php benchmarks/run.php [rounds] [suite...]
+ *
+ * Suites: calls (overhead of the zend_execute_ex hook per call in each
+ * mode), dump (zendump() versus var_dump()) and opcodes (zendump_opcodes()
+ * on a large op_array). The extension is loaded with the setting below,
+ * override it with the ZENDUMP_BENCH_ZENDUMP environment variable when it is
+ * not found by name, or set it empty when it is loaded from php.ini.
+ */
+
+$rounds = isset($argv[1]) ? max(1, (int)$argv[1]) : 5;
+$suites = array_slice($argv, 2) ?: ['calls', 'dump', 'opcodes'];
+$extension = getenv('ZENDUMP_BENCH_ZENDUMP');
+if ($extension === false) {
+	$extension = '-d extension=zendump';
+}
+
+$modes = [
+	'calls' => [
+		'none'           => null,
+		'off'            => '',
+		'trace'          => '-d zendump.enable_trace=1',
+		'type_profile'   => '-d zendump.enable_type_profile=1',
+		'opcode_profile' => '-d zendump.enable_opcode_profile=1',
+		'line_profile'   => '-d zendump.enable_line_profile=1',
+	],
+	'dump' => [
+		'off' => '',
+	],
+	'opcodes' => [
+		'off' => '',
+	],
+];
+
+exec(PHP_BINARY . " $extension -r " . escapeshellarg("exit(extension_loaded('zendump') ? 0 : 1);") . ' 2>/dev/null', $output, $status);
+if ($status !== 0) {
+	fwrite(STDERR, "zendump is not available with: $extension\n");
+	exit(1);
+}
+
+foreach ($suites as $suite) {
+	if (!isset($modes[$suite])) {
+		fwrite(STDERR, "unknown suite: $suite\n");
+		exit(1);
+	}
+	foreach ($modes[$suite] as $mode => $args) {
+		$command = PHP_BINARY . ' ' . ($args === null ? '' : "$extension $args ") . escapeshellarg(__DIR__ . "/$suite.php") . ' 2>/dev/null';
+		$best = [];
+		for ($round = 0; $round < $rounds; ++$round) {
+			$lines = [];
+			exec($command, $lines, $status);
+			if ($status !== 0) {
+				fwrite(STDERR, "$suite/$mode failed with status $status\n");
+				continue 2;
+			}
+			foreach ($lines as $line) {
+				$result = json_decode($line, true);
+				if (!is_array($result)) {
+					continue;
+				}
+				$case = $result['case'];
+				if (!isset($best[$case]) || $result['value'] < $best[$case]['value']) {
+					$best[$case] = $result;
+				}
+			}
+		}
+		foreach ($best as $result) {
+			echo json_encode(['suite' => $suite, 'mode' => $mode, 'php' => PHP_VERSION, 'rounds' => $rounds] + $result), "\n";
+		}
+	}
+}
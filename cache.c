@@ -0,0 +1,451 @@
+/*
+  +----------------------------------------------------------------------+
+  | PHP Version 7                                                        |
+  +----------------------------------------------------------------------+
+  | Copyright (c) 1997-2018 The PHP Group                                |
+  +----------------------------------------------------------------------+
+  | This source file is subject to version 3.01 of the PHP license,      |
+  | that is bundled with this package in the file LICENSE, and is        |
+  | available through the world-wide-web at the following url:           |
+  | http://www.php.net/license/3_01.txt                                  |
+  | If you did not receive a copy of the PHP license and are unable to   |
+  | obtain it through the world-wide-web, please send a note to          |
+  | license@php.net so we can mail you a copy immediately.               |
+  +----------------------------------------------------------------------+
+  | Author: Youlin Feng <fengyoulin@php7th.com>                          |
+  +----------------------------------------------------------------------+
+*/
+
+/* $Id$ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "php.h"
+#include "php_ini.h"
+#include "ext/standard/info.h"
+#include "php_zendump.h"
+#include "zend_smart_str.h"
+
+ZEND_EXTERN_MODULE_GLOBALS(zendump)
+
+#define CACHE_SLOT_RAW          0
+#define CACHE_SLOT_FUNCTION     1
+#define CACHE_SLOT_CLASS        2
+#define CACHE_SLOT_CLASS_METHOD 3
+#define CACHE_SLOT_CLASS_OFFSET 4
+
+typedef struct _zendump_cache_site {
+	uint64_t hits;
+	uint64_t misses;
+	uint64_t cold;
+} zendump_cache_site;
+
+/* Property accesses keep a (class, offset) pair in their cache slot, which
+   only stays valid while every object reaching the site has the same class. */
+static int zendump_cache_slot_is_property(zend_uchar opcode)
+{
+	switch(opcode) {
+		case ZEND_FETCH_OBJ_R:
+		case ZEND_FETCH_OBJ_W:
+		case ZEND_FETCH_OBJ_RW:
+		case ZEND_FETCH_OBJ_IS:
+		case ZEND_FETCH_OBJ_FUNC_ARG:
+		case ZEND_FETCH_OBJ_UNSET:
+		case ZEND_ASSIGN_OBJ:
+		case ZEND_ISSET_ISEMPTY_PROP_OBJ:
+		case ZEND_PRE_INC_OBJ:
+		case ZEND_PRE_DEC_OBJ:
+		case ZEND_POST_INC_OBJ:
+		case ZEND_POST_DEC_OBJ:
+		case ZEND_UNSET_OBJ:
+			return 1;
+	}
+	return 0;
+}
+
+/* In PHP 7.0 - 7.2 the cache slot of an opline is stored in the CONST
+   literal it caches the lookup of, as a byte offset into run_time_cache. */
+static int zendump_cache_slot_kind(zend_op *opline, int op2)
+{
+	switch(opline->opcode) {
+		case ZEND_INIT_FCALL:
+		case ZEND_INIT_FCALL_BY_NAME:
+		case ZEND_INIT_NS_FCALL_BY_NAME:
+			return CACHE_SLOT_FUNCTION;
+		case ZEND_INIT_METHOD_CALL:
+			return CACHE_SLOT_CLASS_METHOD;
+		case ZEND_INIT_STATIC_METHOD_CALL:
+			if(!op2) {
+				return CACHE_SLOT_CLASS;
+			}
+			return opline->op1_type == IS_CONST ? CACHE_SLOT_FUNCTION : CACHE_SLOT_CLASS_METHOD;
+		case ZEND_NEW:
+		case ZEND_FETCH_CLASS:
+		case ZEND_INSTANCEOF:
+		case ZEND_ADD_INTERFACE:
+		case ZEND_ADD_TRAIT:
+			return CACHE_SLOT_CLASS;
+	}
+	if(op2 && zendump_cache_slot_is_property(opline->opcode)) {
+		return CACHE_SLOT_CLASS_OFFSET;
+	}
+	return CACHE_SLOT_RAW;
+}
+
+static void zendump_cache_slot_dump(zend_op_array *op_array, zend_op *opline, zval *literal, int op2, zendump_cache_site *site)
+{
+	void **slot = op_array->run_time_cache ? (void**)((char*)op_array->run_time_cache + Z_CACHE_SLOT_P(literal)) : NULL;
+	int kind = zendump_cache_slot_kind(opline, op2);
+
+	php_printf("%*c#%u %s line(%u) op%d slot(%u)", INDENT_SIZE, ' ', (uint32_t)(opline - op_array->opcodes), zend_get_opcode_name(opline->opcode), opline->lineno, op2 ? 2 : 1, Z_CACHE_SLOT_P(literal));
+	if(!slot || !slot[0]) {
+		PUTS(" empty");
+	} else {
+		switch(kind) {
+			case CACHE_SLOT_FUNCTION:
+				php_printf(" function(%s%s%s)",
+					((zend_function*)slot[0])->common.scope ? ZSTR_VAL(((zend_function*)slot[0])->common.scope->name) : "",
+					((zend_function*)slot[0])->common.scope ? "::" : "",
+					ZSTR_VAL(((zend_function*)slot[0])->common.function_name));
+				break;
+			case CACHE_SLOT_CLASS:
+				php_printf(" class(%s)", ZSTR_VAL(((zend_class_entry*)slot[0])->name));
+				break;
+			case CACHE_SLOT_CLASS_METHOD:
+				php_printf(" class(%s)", ZSTR_VAL(((zend_class_entry*)slot[0])->name));
+				if(slot[1]) {
+					php_printf(" function(%s)", ZSTR_VAL(((zend_function*)slot[1])->common.function_name));
+				}
+				break;
+			case CACHE_SLOT_CLASS_OFFSET:
+				php_printf(" class(%s) offset(%" PRIuPTR ")", ZSTR_VAL(((zend_class_entry*)slot[0])->name), (uintptr_t)slot[1]);
+				break;
+			default:
+				php_printf(" value(0x" ZEND_XLONG_FMT ")", slot[0]);
+		}
+	}
+	if(site) {
+		php_printf(" hits(%" PRIu64 ") misses(%" PRIu64 ") cold(%" PRIu64 ")", site->hits, site->misses, site->cold);
+	}
+	PUTS("\n");
+}
+
+void zendump_runtime_cache_dump(zend_op_array *op_array)
+{
+	zendump_op_array_profile *profile = ZENDUMP_G(enable_cache_profile) ? zendump_profile_find(op_array, 0) : NULL;
+	zendump_cache_site *site;
+	uint32_t idx, count = 0, populated = 0;
+	zval *literal;
+
+	for(idx = 0; idx < op_array->last; ++idx) {
+		zend_op *opline = op_array->opcodes + idx;
+		if(opline->op1_type == IS_CONST && Z_CACHE_SLOT_P(RT_CONSTANT(op_array, opline->op1)) != (uint32_t)-1) {
+			++count;
+			if(op_array->run_time_cache && *(void**)((char*)op_array->run_time_cache + Z_CACHE_SLOT_P(RT_CONSTANT(op_array, opline->op1)))) {
+				++populated;
+			}
+		}
+		if(opline->op2_type == IS_CONST && Z_CACHE_SLOT_P(RT_CONSTANT(op_array, opline->op2)) != (uint32_t)-1) {
+			++count;
+			if(op_array->run_time_cache && *(void**)((char*)op_array->run_time_cache + Z_CACHE_SLOT_P(RT_CONSTANT(op_array, opline->op2)))) {
+				++populated;
+			}
+		}
+	}
+
+	php_printf("runtime_cache(%s%s%s) size(%u) slots(%u) populated(%u): {\n",
+		op_array->scope ? ZSTR_VAL(op_array->scope->name) : "",
+		op_array->scope ? "::" : "",
+		op_array->function_name ? ZSTR_VAL(op_array->function_name) : "{main}",
+		op_array->cache_size, count, populated);
+	for(idx = 0; idx < op_array->last; ++idx) {
+		zend_op *opline = op_array->opcodes + idx;
+		site = (profile && profile->cache_sites) ? zend_hash_index_find_ptr(profile->cache_sites, idx) : NULL;
+		if(opline->op1_type == IS_CONST) {
+			literal = RT_CONSTANT(op_array, opline->op1);
+			if(Z_CACHE_SLOT_P(literal) != (uint32_t)-1) {
+				zendump_cache_slot_dump(op_array, opline, literal, 0, NULL);
+			}
+		}
+		if(opline->op2_type == IS_CONST) {
+			literal = RT_CONSTANT(op_array, opline->op2);
+			if(Z_CACHE_SLOT_P(literal) != (uint32_t)-1) {
+				zendump_cache_slot_dump(op_array, opline, literal, 1, site);
+			}
+		}
+	}
+	PUTS("}\n");
+}
+
+static void zendump_cache_site_dtor(zval *zv)
+{
+	efree(Z_PTR_P(zv));
+}
+
+/* Runs before the handler, so the slot still holds the class seen by the
+   previous execution: a different class means the handler will miss. */
+void zendump_runtime_cache_observe(zend_execute_data *execute_data, const zend_op *opline)
+{
+	zend_op_array *op_array = &EX(func)->op_array;
+	zendump_op_array_profile *profile;
+	zendump_cache_site *site;
+	uint32_t num = opline - op_array->opcodes;
+	zval *object;
+	void **slot;
+
+	if(opline->op2_type != IS_CONST || num >= op_array->last || !EX(run_time_cache)) {
+		return;
+	}
+	if(opline->op1_type == IS_UNUSED) {
+		object = &EX(This);
+	} else {
+		object = zendump_operand_zval(execute_data, opline->op1_type, &opline->op1);
+	}
+	if(object && Z_TYPE_P(object) == IS_REFERENCE) {
+		object = Z_REFVAL_P(object);
+	}
+	if(!object || Z_TYPE_P(object) != IS_OBJECT) {
+		return;
+	}
+
+	profile = zendump_profile_find(op_array, 1);
+	if(!profile->cache_sites) {
+		ALLOC_HASHTABLE(profile->cache_sites);
+		zend_hash_init(profile->cache_sites, 8, NULL, zendump_cache_site_dtor, 0);
+	}
+	site = zend_hash_index_find_ptr(profile->cache_sites, num);
+	if(!site) {
+		site = ecalloc(1, sizeof(zendump_cache_site));
+		zend_hash_index_add_new_ptr(profile->cache_sites, num, site);
+	}
+
+	slot = (void**)((char*)EX(run_time_cache) + Z_CACHE_SLOT_P(RT_CONSTANT(op_array, opline->op2)));
+	if(!slot[0]) {
+		++site->cold;
+	} else if(slot[0] == Z_OBJCE_P(object)) {
+		++site->hits;
+	} else {
+		++site->misses;
+	}
+}
+
+void zendump_runtime_cache_startup()
+{
+	zend_uchar opcode;
+
+	zendump_observe_opcode(ZEND_INIT_METHOD_CALL, zendump_runtime_cache_observe);
+	for(opcode = 0; opcode < ZEND_VM_LAST_OPCODE; ++opcode) {
+		if(zendump_cache_slot_is_property(opcode)) {
+			zendump_observe_opcode(opcode, zendump_runtime_cache_observe);
+		}
+	}
+}
+
+#define RECEIVER_CLASSES 4
+
+typedef struct _zendump_receiver_site {
+	zend_string *filename;
+	uint32_t    lineno;
+	uint32_t    num;
+	zend_string *proto;
+	uint64_t    total;
+	uint64_t    other;
+	zend_string *classes[RECEIVER_CLASSES];
+	uint64_t    hits[RECEIVER_CLASSES];
+} zendump_receiver_site;
+
+static void zendump_receiver_site_dtor(zval *zv)
+{
+	zendump_receiver_site *site = (zendump_receiver_site*)Z_PTR_P(zv);
+	uint32_t idx;
+
+	if(site->filename) {
+		zend_string_release(site->filename);
+	}
+	if(site->proto) {
+		zend_string_release(site->proto);
+	}
+	for(idx = 0; idx < RECEIVER_CLASSES && site->classes[idx]; ++idx) {
+		zend_string_release(site->classes[idx]);
+	}
+	pefree(site, 1);
+}
+
+static zend_class_entry *zendump_receiver_scope(zend_execute_data *execute_data, uint32_t fetch_type)
+{
+	zend_class_entry *scope = EX(func)->op_array.scope;
+
+	switch(fetch_type & ZEND_FETCH_CLASS_MASK) {
+		case ZEND_FETCH_CLASS_SELF:
+			return scope;
+		case ZEND_FETCH_CLASS_PARENT:
+			return scope ? scope->parent : NULL;
+		case ZEND_FETCH_CLASS_STATIC:
+#if PHP_API_VERSION >= 20160303
+			if(Z_TYPE(EX(This)) == IS_OBJECT) {
+				return Z_OBJCE(EX(This));
+			}
+			return Z_CE(EX(This));
+#else
+			return EX(called_scope);
+#endif
+	}
+	return NULL;
+}
+
+/* The receiver class is taken before the handler runs: the object of a
+   method call, or the class a static call resolves to, which only varies
+   for static:: and for class names held in variables. */
+void zendump_receiver_observe(zend_execute_data *execute_data, const zend_op *opline)
+{
+	zend_op_array *op_array = &EX(func)->op_array;
+	zendump_receiver_site *site;
+	zend_class_entry *ce = NULL;
+	zend_string *name = NULL;
+	zend_function *fbc = NULL;
+	uint32_t num = opline - op_array->opcodes, idx;
+	char *key;
+	size_t key_len;
+	zval *object;
+
+	if(num >= op_array->last || !op_array->filename) {
+		return;
+	}
+	if(opline->opcode == ZEND_INIT_METHOD_CALL) {
+		if(opline->op1_type == IS_UNUSED) {
+			object = &EX(This);
+		} else {
+			object = zendump_operand_zval(execute_data, opline->op1_type, &opline->op1);
+		}
+		if(object && Z_TYPE_P(object) == IS_REFERENCE) {
+			object = Z_REFVAL_P(object);
+		}
+		if(!object || Z_TYPE_P(object) != IS_OBJECT) {
+			return;
+		}
+		ce = Z_OBJCE_P(object);
+	} else if(opline->op1_type == IS_CONST) {
+		/* The lowercased name follows the literal, a class that is not
+		   loaded yet is counted by name without triggering the autoloader. */
+		ce = zend_hash_find_ptr(EG(class_table), Z_STR_P(RT_CONSTANT(op_array, opline->op1) + 1));
+		if(!ce) {
+			name = Z_STR_P(RT_CONSTANT(op_array, opline->op1));
+		}
+	} else if(opline->op1_type == IS_UNUSED) {
+		ce = zendump_receiver_scope(execute_data, opline->op1.num);
+	} else {
+		ce = Z_CE_P(EX_VAR(opline->op1.var));
+	}
+	if(ce) {
+		name = ce->name;
+		if(opline->op2_type == IS_CONST) {
+			fbc = zend_hash_find_ptr(&ce->function_table, Z_STR_P(RT_CONSTANT(op_array, opline->op2) + 1));
+		}
+	}
+	if(!name) {
+		return;
+	}
+
+	key_len = spprintf(&key, 0, "%s:%u#%u", ZSTR_VAL(op_array->filename), opline->lineno, num);
+	site = zendump_pool_record(&ZENDUMP_G(receiver_sites), key, key_len, sizeof(zendump_receiver_site), zendump_receiver_site_dtor);
+	efree(key);
+	if(!site->filename) {
+		site->filename = zend_string_init(ZSTR_VAL(op_array->filename), ZSTR_LEN(op_array->filename), 1);
+		site->lineno = opline->lineno;
+		site->num = num;
+	}
+	if(!site->proto && fbc) {
+		smart_str buf = {0};
+		zendump_zend_function_proto_append(&buf, fbc);
+		smart_str_0(&buf);
+		site->proto = zend_string_init(ZSTR_VAL(buf.s), ZSTR_LEN(buf.s), 1);
+		smart_str_free(&buf);
+	}
+
+	++site->total;
+	for(idx = 0; idx < RECEIVER_CLASSES && site->classes[idx]; ++idx) {
+		if(zend_string_equals(site->classes[idx], name)) {
+			++site->hits[idx];
+			return;
+		}
+	}
+	if(idx < RECEIVER_CLASSES) {
+		site->classes[idx] = zend_string_init(ZSTR_VAL(name), ZSTR_LEN(name), 1);
+		site->hits[idx] = 1;
+	} else {
+		++site->other;
+	}
+}
+
+static uint32_t zendump_receiver_site_classes(const zendump_receiver_site *site)
+{
+	uint32_t count = 0;
+	while(count < RECEIVER_CLASSES && site->classes[count]) {
+		++count;
+	}
+	return count + (site->other ? 1 : 0);
+}
+
+static int zendump_receiver_site_compare(const void *a, const void *b)
+{
+	const zendump_receiver_site *x = *(const zendump_receiver_site**)a;
+	const zendump_receiver_site *y = *(const zendump_receiver_site**)b;
+	uint32_t cx = zendump_receiver_site_classes(x), cy = zendump_receiver_site_classes(y);
+	if(cx != cy) {
+		return cx < cy ? 1 : -1;
+	}
+	if(x->total != y->total) {
+		return x->total < y->total ? 1 : -1;
+	}
+	return 0;
+}
+
+void zendump_receiver_dump(zend_long limit, zend_long min_classes)
+{
+	zendump_receiver_site **sites = NULL, *site;
+	uint32_t count = 0, idx, num;
+
+	if(ZENDUMP_G(receiver_sites)) {
+		sites = safe_emalloc(zend_hash_num_elements(ZENDUMP_G(receiver_sites)) + 1, sizeof(zendump_receiver_site*), 0);
+		ZEND_HASH_FOREACH_PTR(ZENDUMP_G(receiver_sites), site) {
+			if(zendump_receiver_site_classes(site) >= min_classes) {
+				sites[count++] = site;
+			}
+		} ZEND_HASH_FOREACH_END();
+		qsort(sites, count, sizeof(zendump_receiver_site*), zendump_receiver_site_compare);
+	}
+	if(limit > 0 && limit < count) {
+		php_printf("receivers(%u/%u): {\n", (uint32_t)limit, count);
+	} else {
+		php_printf("receivers(%u): {\n", count);
+		limit = count;
+	}
+	for(idx = 0; idx < limit; ++idx) {
+		site = sites[idx];
+		php_printf("%*c%s:%u #%u %s total(%" PRIu64 ") classes(%u): {\n", INDENT_SIZE, ' ', ZSTR_VAL(site->filename), site->lineno, site->num, site->proto ? ZSTR_VAL(site->proto) : "-", site->total, zendump_receiver_site_classes(site));
+		for(num = 0; num < RECEIVER_CLASSES && site->classes[num]; ++num) {
+			php_printf("%*c%s %" PRIu64 " %.2f%%\n", INDENT_SIZE * 2, ' ', ZSTR_VAL(site->classes[num]), site->hits[num], site->hits[num] * 100.0 / site->total);
+		}
+		if(site->other) {
+			php_printf("%*cother %" PRIu64 " %.2f%%\n", INDENT_SIZE * 2, ' ', site->other, site->other * 100.0 / site->total);
+		}
+		php_printf("%*c}\n", INDENT_SIZE, ' ');
+	}
+	PUTS("}\n");
+	if(sites) {
+		efree(sites);
+	}
+}
+
+void zendump_receiver_startup()
+{
+	zendump_observe_opcode(ZEND_INIT_METHOD_CALL, zendump_receiver_observe);
+	zendump_observe_opcode(ZEND_INIT_STATIC_METHOD_CALL, zendump_receiver_observe);
+}
+
+void zendump_receiver_shutdown()
+{
+	zendump_pool_destroy(&ZENDUMP_G(receiver_sites));
+}
@@ -0,0 +1,340 @@
+/*
+  +----------------------------------------------------------------------+
+  | PHP Version 7                                                        |
+  +----------------------------------------------------------------------+
+  | Copyright (c) 1997-2018 The PHP Group                                |
+  +----------------------------------------------------------------------+
+  | This source file is subject to version 3.01 of the PHP license,      |
+  | that is bundled with this package in the file LICENSE, and is        |
+  | available through the world-wide-web at the following url:           |
+  | http://www.php.net/license/3_01.txt                                  |
+  | If you did not receive a copy of the PHP license and are unable to   |
+  | obtain it through the world-wide-web, please send a note to          |
+  | license@php.net so we can mail you a copy immediately.               |
+  +----------------------------------------------------------------------+
+  | Author: Youlin Feng <fengyoulin@php7th.com>                          |
+  +----------------------------------------------------------------------+
+*/
+
+/* $Id$ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "php.h"
+#include "php_ini.h"
+#include "ext/standard/info.h"
+#include "php_zendump.h"
+#include "zend_smart_str.h"
+
+ZEND_EXTERN_MODULE_GLOBALS(zendump)
+
+#define CFG_EDGE_FALLTHROUGH 0
+#define CFG_EDGE_JUMP        1
+#define CFG_EDGE_SWITCH      2
+#define CFG_EDGE_EXCEPTION   3
+
+typedef struct _zendump_cfg_edge {
+	uint32_t from;
+	uint32_t to;
+	int      type;
+} zendump_cfg_edge;
+
+typedef struct _zendump_cfg {
+	zend_op_array    *op_array;
+	uint32_t         *block_of;  /* opline number => block number */
+	uint32_t         *starts;    /* block number => first opline */
+	uint32_t         count;
+	zendump_cfg_edge *edges;
+	uint32_t         edges_count;
+	uint32_t         edges_size;
+} zendump_cfg;
+
+/* Decodes the static jump targets of an opline, the same operands that
+   zendump_znode_op_dump() prints as relative numbers. Returns the number of
+   targets and sets *falls_through when the next opline is also a successor. */
+uint32_t zendump_jump_targets(zend_op_array *op_array, zend_op *opline, uint32_t *targets, uint32_t size, int *falls_through)
+{
+	uint32_t count = 0;
+#if PHP_API_VERSION >= 20160303
+	uint32_t flags = zend_get_opcode_flags(opline->opcode);
+
+	if((ZEND_VM_OP1_FLAGS(flags) & ZEND_VM_OP_MASK) == ZEND_VM_OP_JMP_ADDR && count < size) {
+		targets[count++] = OP_JMP_ADDR(opline, opline->op1) - op_array->opcodes;
+	}
+	if((ZEND_VM_OP2_FLAGS(flags) & ZEND_VM_OP_MASK) == ZEND_VM_OP_JMP_ADDR && count < size) {
+		targets[count++] = OP_JMP_ADDR(opline, opline->op2) - op_array->opcodes;
+	}
+	if((flags & ZEND_VM_EXT_MASK) == ZEND_VM_EXT_JMP_ADDR && count < size) {
+		targets[count++] = ZEND_OFFSET_TO_OPLINE(opline, opline->extended_value) - op_array->opcodes;
+	}
+#else
+	if(opline->opcode == ZEND_JMP || opline->opcode == ZEND_FAST_CALL) {
+		targets[count++] = OP_JMP_ADDR(opline, opline->op1) - op_array->opcodes;
+	} else if(opline->opcode == ZEND_JMPZ ||
+		opline->opcode == ZEND_JMPNZ ||
+		opline->opcode == ZEND_JMPZNZ ||
+		opline->opcode == ZEND_JMPZ_EX ||
+		opline->opcode == ZEND_JMPNZ_EX ||
+		opline->opcode == ZEND_JMP_SET ||
+		opline->opcode == ZEND_FE_RESET_R ||
+		opline->opcode == ZEND_FE_RESET_RW ||
+		opline->opcode == ZEND_COALESCE ||
+		opline->opcode == ZEND_ASSERT_CHECK) {
+		targets[count++] = OP_JMP_ADDR(opline, opline->op2) - op_array->opcodes;
+	}
+	if((opline->opcode == ZEND_JMPZNZ ||
+		opline->opcode == ZEND_CATCH ||
+		opline->opcode == ZEND_FE_FETCH_R ||
+		opline->opcode == ZEND_FE_FETCH_RW) && count < size) {
+		targets[count++] = ZEND_OFFSET_TO_OPLINE(opline, opline->extended_value) - op_array->opcodes;
+	}
+#endif
+#ifdef ZEND_SWITCH_LONG
+	if(opline->opcode == ZEND_SWITCH_LONG || opline->opcode == ZEND_SWITCH_STRING) {
+		zval *jumptable = RT_CONSTANT(op_array, opline->op2), *zv;
+		ZEND_HASH_FOREACH_VAL(Z_ARRVAL_P(jumptable), zv) {
+			if(count < size) {
+				targets[count++] = ZEND_OFFSET_TO_OPLINE(opline, Z_LVAL_P(zv)) - op_array->opcodes;
+			}
+		} ZEND_HASH_FOREACH_END();
+		if(count < size) {
+			targets[count++] = ZEND_OFFSET_TO_OPLINE(opline, opline->extended_value) - op_array->opcodes;
+		}
+	}
+#endif
+
+	switch(opline->opcode) {
+		case ZEND_JMP:
+		case ZEND_JMPZNZ:
+		case ZEND_RETURN:
+		case ZEND_RETURN_BY_REF:
+		case ZEND_GENERATOR_RETURN:
+		case ZEND_THROW:
+		case ZEND_EXIT:
+		case ZEND_FAST_RET:
+			*falls_through = 0;
+			break;
+		default:
+			*falls_through = 1;
+	}
+	return count;
+}
+
+static void zendump_cfg_add_edge(zendump_cfg *cfg, uint32_t from, uint32_t to, int type)
+{
+	uint32_t idx;
+	for(idx = 0; idx < cfg->edges_count; ++idx) {
+		if(cfg->edges[idx].from == from && cfg->edges[idx].to == to) {
+			return;
+		}
+	}
+	if(cfg->edges_count == cfg->edges_size) {
+		cfg->edges_size = cfg->edges_size ? (cfg->edges_size << 1) : 16;
+		cfg->edges = safe_erealloc(cfg->edges, cfg->edges_size, sizeof(zendump_cfg_edge), 0);
+	}
+	cfg->edges[cfg->edges_count].from = from;
+	cfg->edges[cfg->edges_count].to = to;
+	cfg->edges[cfg->edges_count].type = type;
+	++cfg->edges_count;
+}
+
+static void zendump_cfg_build(zendump_cfg *cfg, zend_op_array *op_array)
+{
+	zend_uchar *leaders = ecalloc(op_array->last + 1, 1);
+	uint32_t *targets = safe_emalloc(op_array->last + 2, sizeof(uint32_t), 0);
+	uint32_t idx, num, count;
+	int falls_through;
+
+	memset(cfg, 0, sizeof(zendump_cfg));
+	cfg->op_array = op_array;
+
+	leaders[0] = 1;
+	for(idx = 0; idx < op_array->last; ++idx) {
+		count = zendump_jump_targets(op_array, op_array->opcodes + idx, targets, op_array->last + 2, &falls_through);
+		for(num = 0; num < count; ++num) {
+			if(targets[num] < op_array->last) {
+				leaders[targets[num]] = 1;
+			}
+		}
+		if(count || !falls_through) {
+			leaders[idx + 1] = 1;
+		}
+	}
+	for(idx = 0; idx < op_array->last_try_catch; ++idx) {
+		zend_try_catch_element *element = op_array->try_catch_array + idx;
+		leaders[element->try_op] = 1;
+		if(element->catch_op) {
+			leaders[element->catch_op] = 1;
+		}
+		if(element->finally_op) {
+			leaders[element->finally_op] = 1;
+			leaders[element->finally_end] = 1;
+		}
+	}
+
+	cfg->block_of = safe_emalloc(op_array->last + 1, sizeof(uint32_t), 0);
+	cfg->starts = safe_emalloc(op_array->last + 1, sizeof(uint32_t), 0);
+	for(idx = 0; idx < op_array->last; ++idx) {
+		if(leaders[idx]) {
+			cfg->starts[cfg->count++] = idx;
+		}
+		cfg->block_of[idx] = cfg->count - 1;
+	}
+	cfg->starts[cfg->count] = op_array->last;
+
+	for(num = 0; num < cfg->count; ++num) {
+		uint32_t last = cfg->starts[num + 1] - 1, target;
+		count = zendump_jump_targets(op_array, op_array->opcodes + last, targets, op_array->last + 2, &falls_through);
+		for(idx = 0; idx < count; ++idx) {
+			if(targets[idx] < op_array->last) {
+#ifdef ZEND_SWITCH_LONG
+				int type = (op_array->opcodes[last].opcode == ZEND_SWITCH_LONG || op_array->opcodes[last].opcode == ZEND_SWITCH_STRING) ? CFG_EDGE_SWITCH : CFG_EDGE_JUMP;
+#else
+				int type = CFG_EDGE_JUMP;
+#endif
+				zendump_cfg_add_edge(cfg, num, cfg->block_of[targets[idx]], type);
+			}
+		}
+		if(falls_through && last + 1 < op_array->last) {
+			zendump_cfg_add_edge(cfg, num, num + 1, CFG_EDGE_FALLTHROUGH);
+		}
+		for(idx = 0; idx < op_array->last_try_catch; ++idx) {
+			zend_try_catch_element *element = op_array->try_catch_array + idx;
+			uint32_t try_end = element->catch_op ? element->catch_op : element->finally_op;
+			if(cfg->starts[num] < element->try_op || cfg->starts[num] >= try_end) {
+				continue;
+			}
+			target = element->catch_op ? element->catch_op : element->finally_op;
+			zendump_cfg_add_edge(cfg, num, cfg->block_of[target], CFG_EDGE_EXCEPTION);
+			if(element->catch_op && element->finally_op) {
+				zendump_cfg_add_edge(cfg, num, cfg->block_of[element->finally_op], CFG_EDGE_EXCEPTION);
+			}
+		}
+	}
+
+	efree(targets);
+	efree(leaders);
+}
+
+static void zendump_cfg_free(zendump_cfg *cfg)
+{
+	efree(cfg->block_of);
+	efree(cfg->starts);
+	if(cfg->edges) {
+		efree(cfg->edges);
+	}
+}
+
+static void zendump_cfg_printf(smart_str *buf, const char *format, ...)
+{
+	va_list args;
+	char *str = NULL;
+	size_t len;
+
+	va_start(args, format);
+	len = vspprintf(&str, 0, format, args);
+	va_end(args);
+
+	smart_str_appendl(buf, str, len);
+	efree(str);
+}
+
+static void zendump_cfg_append_escaped(smart_str *buf, const char *str, size_t len)
+{
+	size_t idx;
+	for(idx = 0; idx < len; ++idx) {
+		if(str[idx] == '"' || str[idx] == '\\') {
+			smart_str_appendc(buf, '\\');
+		}
+		smart_str_appendc(buf, str[idx]);
+	}
+}
+
+static void zendump_cfg_append_name(smart_str *buf, zend_op_array *op_array)
+{
+	if(op_array->scope && op_array->scope->name) {
+		zendump_cfg_append_escaped(buf, ZSTR_VAL(op_array->scope->name), ZSTR_LEN(op_array->scope->name));
+		smart_str_appends(buf, "::");
+	}
+	if(op_array->function_name) {
+		zendump_cfg_append_escaped(buf, ZSTR_VAL(op_array->function_name), ZSTR_LEN(op_array->function_name));
+	} else {
+		smart_str_appends(buf, "{main}");
+	}
+}
+
+static uint32_t zendump_cfg_line(zend_op_array *op_array, uint32_t from, uint32_t to, int last)
+{
+	uint32_t idx, line = op_array->opcodes[from].lineno;
+	for(idx = from; idx < to; ++idx) {
+		if(last ? op_array->opcodes[idx].lineno > line : op_array->opcodes[idx].lineno < line) {
+			line = op_array->opcodes[idx].lineno;
+		}
+	}
+	return line;
+}
+
+zend_string *zendump_cfg_export(zend_op_array *op_array, int json)
+{
+	const char *edge_types[] = {"fallthrough", "jump", "switch", "exception"};
+	zendump_op_array_profile *profile = ZENDUMP_G(enable_opcode_profile) ? zendump_profile_find(op_array, 0) : NULL;
+	zendump_cfg cfg;
+	smart_str buf = {0};
+	uint32_t num, idx;
+
+	zendump_cfg_build(&cfg, op_array);
+
+	if(json) {
+		smart_str_appends(&buf, "{\"function\":\"");
+		zendump_cfg_append_name(&buf, op_array);
+		smart_str_appends(&buf, "\",\"blocks\":[");
+	} else {
+		smart_str_appends(&buf, "digraph \"");
+		zendump_cfg_append_name(&buf, op_array);
+		smart_str_appends(&buf, "\" {\n  node [shape=box, fontname=\"monospace\"];\n");
+	}
+	for(num = 0; num < cfg.count; ++num) {
+		uint32_t start = cfg.starts[num], end = cfg.starts[num + 1];
+		if(json) {
+			zendump_cfg_printf(&buf, "%s{\"id\":%u,\"start\":%u,\"end\":%u,\"line_start\":%u,\"line_end\":%u", num ? "," : "", num, start, end - 1, zendump_cfg_line(op_array, start, end, 0), zendump_cfg_line(op_array, start, end, 1));
+			if(profile) {
+				zendump_cfg_printf(&buf, ",\"hits\":%" PRIu64, profile->hits[start]);
+			}
+			smart_str_appends(&buf, ",\"opcodes\":[");
+			for(idx = start; idx < end; ++idx) {
+				zendump_cfg_printf(&buf, "%s\"%s\"", idx > start ? "," : "", zend_get_opcode_name(op_array->opcodes[idx].opcode));
+			}
+			smart_str_appends(&buf, "]}");
+		} else {
+			zendump_cfg_printf(&buf, "  B%u [label=\"B%u #%u-%u line %u-%u", num, num, start, end - 1, zendump_cfg_line(op_array, start, end, 0), zendump_cfg_line(op_array, start, end, 1));
+			if(profile) {
+				zendump_cfg_printf(&buf, " hits %" PRIu64, profile->hits[start]);
+			}
+			smart_str_appends(&buf, "\\l");
+			for(idx = start; idx < end; ++idx) {
+				zendump_cfg_printf(&buf, "%u %s\\l", idx, zend_get_opcode_name(op_array->opcodes[idx].opcode));
+			}
+			smart_str_appends(&buf, "\"];\n");
+		}
+	}
+	if(json) {
+		smart_str_appends(&buf, "],\"edges\":[");
+	}
+	for(idx = 0; idx < cfg.edges_count; ++idx) {
+		zendump_cfg_edge *edge = cfg.edges + idx;
+		if(json) {
+			zendump_cfg_printf(&buf, "%s{\"from\":%u,\"to\":%u,\"type\":\"%s\"}", idx ? "," : "", edge->from, edge->to, edge_types[edge->type]);
+		} else if(edge->type == CFG_EDGE_FALLTHROUGH) {
+			zendump_cfg_printf(&buf, "  B%u -> B%u;\n", edge->from, edge->to);
+		} else {
+			zendump_cfg_printf(&buf, "  B%u -> B%u [label=\"%s\"%s];\n", edge->from, edge->to, edge_types[edge->type], edge->type == CFG_EDGE_EXCEPTION ? ", style=dashed" : "");
+		}
+	}
+	smart_str_appends(&buf, json ? "]}" : "}\n");
+	smart_str_0(&buf);
+
+	zendump_cfg_free(&cfg);
+	return buf.s;
+}
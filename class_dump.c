@@ -26,10 +26,12 @@
 #include "php_ini.h"
 #include "ext/standard/info.h"
 #include "php_zendump.h"
+#include "zend_objects_API.h"
+
+ZEND_EXTERN_MODULE_GLOBALS(zendump)
 
 void zendump_constants_table_dump(zend_class_entry *ce);
 void zendump_function_table_dump(zend_class_entry *ce);
-zend_string *zendump_properties_offset_to_name(zend_class_entry *ce, uint32_t offset);
 void zendump_access_flags_dump(uint32_t flags);
 void zendump_properties_info_dump(zend_class_entry *ce);
 void zendump_class_traits_dump(zend_class_entry *ce);
@@ -186,21 +188,95 @@ void zendump_class_traits_dump(zend_class_entry *ce)
 	}
 }
 
-zend_string *zendump_properties_offset_to_name(zend_class_entry *ce, uint32_t offset)
+static void zendump_class_layout_dtor(zval *zv)
 {
-	uint32_t idx;
+	zendump_class_layout *layout = (zendump_class_layout*)Z_PTR_P(zv);
+	if(layout->names) {
+		efree(layout->names);
+	}
+	efree(layout);
+}
+
+/* Slot names are borrowed from the keys of ce->properties_info, so the cache
+   must not outlive the request that built it. */
+zendump_class_layout *zendump_class_layout_get(zend_class_entry *ce)
+{
+	zendump_class_layout *layout;
 	zend_property_info *info;
-	for(idx = 0; idx < ce->properties_info.nNumUsed; ++idx) {
-		Bucket *bucket = ce->properties_info.arData + idx;
-		if(Z_TYPE(bucket->val) == IS_UNDEF) {
+	zend_string *key;
+	uint32_t count;
+
+	if(!ZENDUMP_G(class_layouts)) {
+		ALLOC_HASHTABLE(ZENDUMP_G(class_layouts));
+		zend_hash_init(ZENDUMP_G(class_layouts), 16, NULL, zendump_class_layout_dtor, 0);
+	} else if((layout = zend_hash_index_find_ptr(ZENDUMP_G(class_layouts), (zend_ulong)(zend_uintptr_t)ce)) != NULL) {
+		return layout;
+	}
+
+	layout = emalloc(sizeof(zendump_class_layout));
+	layout->properties_count = ce->default_properties_count;
+	layout->static_members_count = ce->default_static_members_count;
+	count = layout->properties_count + layout->static_members_count;
+	layout->names = count ? ecalloc(count, sizeof(zend_string*)) : NULL;
+	ZEND_HASH_FOREACH_STR_KEY_PTR(&ce->properties_info, key, info) {
+		if(!key) {
 			continue;
 		}
-		info = (zend_property_info*)Z_PTR(bucket->val);
-		if(info->offset == offset) {
-			return bucket->key;
+		if(info->flags & ZEND_ACC_STATIC) {
+			if(info->offset < layout->static_members_count) {
+				layout->names[layout->properties_count + info->offset] = key;
+			}
+		} else if(info->offset >= OBJ_PROP_TO_OFFSET(0) && OBJ_PROP_TO_NUM(info->offset) < layout->properties_count) {
+			layout->names[OBJ_PROP_TO_NUM(info->offset)] = key;
 		}
+	} ZEND_HASH_FOREACH_END();
+	zend_hash_index_add_new_ptr(ZENDUMP_G(class_layouts), (zend_ulong)(zend_uintptr_t)ce, layout);
+	return layout;
+}
+
+void zendump_class_layout_reset()
+{
+	if(ZENDUMP_G(class_layouts)) {
+		zend_hash_destroy(ZENDUMP_G(class_layouts));
+		FREE_HASHTABLE(ZENDUMP_G(class_layouts));
+		ZENDUMP_G(class_layouts) = NULL;
 	}
-	return NULL;
+}
+
+void zendump_class_layout_dump(zend_class_entry *ce)
+{
+	zendump_class_layout *layout = zendump_class_layout_get(ce);
+	uint32_t idx, instances = 0, materialized = 0;
+	size_t properties_size = 0;
+
+	for(idx = 1; idx < EG(objects_store).top; ++idx) {
+		zend_object *obj = EG(objects_store).object_buckets[idx];
+		if(!IS_OBJ_VALID(obj) || obj->ce != ce) {
+			continue;
+		}
+		++instances;
+		if(obj->properties) {
+			++materialized;
+			properties_size += sizeof(zend_array);
+			if(obj->properties->u.flags & HASH_FLAG_INITIALIZED) {
+				properties_size += HT_USED_SIZE(obj->properties);
+			}
+		}
+	}
+
+	php_printf("%s class_layout(\"%s\") slots(%u) object_size(%zu) static_members(%u) static_size(%zu) instances(%u) materialized(%u) properties_size(%zu)", ce->type == ZEND_INTERNAL_CLASS ? "internal" : "user", ZSTR_VAL(ce->name), layout->properties_count, sizeof(zend_object) + zend_object_properties_size(ce), layout->static_members_count, layout->static_members_count * sizeof(zval), instances, materialized, properties_size);
+	if(layout->properties_count || layout->static_members_count) {
+		PUTS(" {\n");
+		for(idx = 0; idx < layout->properties_count; ++idx) {
+			php_printf("%*c[%u] offset(%u) $%s\n", INDENT_SIZE, ' ', idx, OBJ_PROP_TO_OFFSET(idx), layout->names[idx] ? ZSTR_VAL(layout->names[idx]) : "");
+		}
+		for(idx = 0; idx < layout->static_members_count; ++idx) {
+			zend_string *name = layout->names[layout->properties_count + idx];
+			php_printf("%*cstatic [%u] $%s\n", INDENT_SIZE, ' ', idx, name ? ZSTR_VAL(name) : "");
+		}
+		PUTS("}");
+	}
+	PUTS("\n");
 }
 
 void zendump_properties_info_dump(zend_class_entry *ce)
@@ -232,7 +308,7 @@ void zendump_properties_info_dump(zend_class_entry *ce)
 			if(info->flags & ZEND_ACC_STATIC) {
 				default_value = ce->default_static_members_table + info->offset;
 			} else {
-				default_value = ce->default_properties_table + (info->offset + sizeof(zval) - sizeof(zend_object)) / sizeof(zval);
+				default_value = ce->default_properties_table + OBJ_PROP_TO_NUM(info->offset);
 			}
 			zendump_zval_dump(default_value, 0);
 		}
@@ -265,12 +341,14 @@ void zendump_access_flags_dump(uint32_t flags)
 void zendump_static_properties_dump(zend_class_entry *ce, int level)
 {
 	int idx;
+	zendump_class_layout *layout;
 	if(!ce->default_static_members_count) {
 		return;
 	}
+	layout = zendump_class_layout_get(ce);
 	php_printf("%*cstatic_members(%d) {\n", level + INDENT_SIZE, ' ', ce->default_static_members_count);
 	for(idx = 0; idx < ce->default_static_members_count; ++idx) {
-		zend_string *name = zendump_properties_offset_to_name(ce, idx);
+		zend_string *name = layout->names[layout->properties_count + idx];
 		if(name) {
 			php_printf("%*c$%s =>\n", level + (INDENT_SIZE << 1), ' ', ZSTR_VAL(name));
 		}
@@ -282,13 +360,14 @@ void zendump_static_properties_dump(zend_class_entry *ce, int level)
 void zendump_properties_dump(zend_object *obj, int level)
 {
 	int idx;
+	zendump_class_layout *layout;
 	if(!obj->ce->default_properties_count) {
 		return;
 	}
+	layout = zendump_class_layout_get(obj->ce);
 	php_printf("%*cdefault_properties(%d) {\n", level + INDENT_SIZE, ' ', obj->ce->default_properties_count);
 	for(idx = 0; idx < obj->ce->default_properties_count; ++idx) {
-		uint32_t offset = sizeof(zend_object) + sizeof(zval) * (idx - 1);
-		zend_string *name = zendump_properties_offset_to_name(obj->ce, offset);
+		zend_string *name = layout->names[idx];
 		if(name) {
 			php_printf("%*c$%s =>\n", level + (INDENT_SIZE << 1), ' ', ZSTR_VAL(name));
 		}
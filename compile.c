@@ -0,0 +1,596 @@
+/*
+  +----------------------------------------------------------------------+
+  | PHP Version 7                                                        |
+  +----------------------------------------------------------------------+
+  | Copyright (c) 1997-2018 The PHP Group                                |
+  +----------------------------------------------------------------------+
+  | This source file is subject to version 3.01 of the PHP license,      |
+  | that is bundled with this package in the file LICENSE, and is        |
+  | available through the world-wide-web at the following url:           |
+  | http://www.php.net/license/3_01.txt                                  |
+  | If you did not receive a copy of the PHP license and are unable to   |
+  | obtain it through the world-wide-web, please send a note to          |
+  | license@php.net so we can mail you a copy immediately.               |
+  +----------------------------------------------------------------------+
+  | Author: Youlin Feng <fengyoulin@php7th.com>                          |
+  +----------------------------------------------------------------------+
+*/
+
+/* $Id$ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "php.h"
+#include "php_ini.h"
+#include "ext/standard/info.h"
+#include "php_zendump.h"
+#include "zend_language_scanner.h"
+
+ZEND_EXTERN_MODULE_GLOBALS(zendump)
+
+typedef struct _zendump_compile_site {
+	zend_string *name;
+	zend_bool   eval;
+	uint64_t    count;
+	uint64_t    time;
+	uint64_t    memory;
+	uint64_t    op_arrays;
+	uint64_t    classes;
+	uint64_t    opcodes;
+} zendump_compile_site;
+
+static void zendump_compile_site_dtor(zval *zv)
+{
+	zendump_compile_site *site = (zendump_compile_site*)Z_PTR_P(zv);
+	zend_string_release(site->name);
+	efree(site);
+}
+
+/* Functions and classes declared by a compilation are appended to the
+   global tables, so everything past the previous nNumUsed is new. */
+static void zendump_compile_count(uint32_t functions_used, uint32_t classes_used, zend_op_array *op_array, zendump_compile_site *site)
+{
+	uint32_t idx;
+	Bucket *p;
+	zend_function *func;
+
+	if(op_array) {
+		++site->op_arrays;
+		site->opcodes += op_array->last;
+	}
+	for(idx = functions_used; idx < CG(function_table)->nNumUsed; ++idx) {
+		p = CG(function_table)->arData + idx;
+		if(Z_TYPE(p->val) == IS_UNDEF) {
+			continue;
+		}
+		func = Z_PTR(p->val);
+		if(func->type == ZEND_USER_FUNCTION) {
+			++site->op_arrays;
+			site->opcodes += func->op_array.last;
+		}
+	}
+	for(idx = classes_used; idx < CG(class_table)->nNumUsed; ++idx) {
+		zend_class_entry *ce;
+		p = CG(class_table)->arData + idx;
+		if(Z_TYPE(p->val) == IS_UNDEF) {
+			continue;
+		}
+		ce = Z_PTR(p->val);
+		if(ce->type != ZEND_USER_CLASS) {
+			continue;
+		}
+		++site->classes;
+		ZEND_HASH_FOREACH_PTR(&ce->function_table, func) {
+			if(func->type == ZEND_USER_FUNCTION && func->common.scope == ce) {
+				++site->op_arrays;
+				site->opcodes += func->op_array.last;
+			}
+		} ZEND_HASH_FOREACH_END();
+	}
+}
+
+static zendump_compile_site *zendump_compile_site_find(const char *name, size_t len, zend_bool eval)
+{
+	zendump_compile_site *site;
+
+	if(!ZENDUMP_G(compile_sites)) {
+		ALLOC_HASHTABLE(ZENDUMP_G(compile_sites));
+		zend_hash_init(ZENDUMP_G(compile_sites), 32, NULL, zendump_compile_site_dtor, 0);
+	}
+	site = zend_hash_str_find_ptr(ZENDUMP_G(compile_sites), name, len);
+	if(!site) {
+		site = ecalloc(1, sizeof(zendump_compile_site));
+		site->name = zend_string_init(name, len, 0);
+		site->eval = eval;
+		zend_hash_add_new_ptr(ZENDUMP_G(compile_sites), site->name, site);
+	}
+	return site;
+}
+
+static void zendump_compile_record(const char *name, size_t len, zend_bool eval, uint64_t start, size_t memory, uint32_t functions_used, uint32_t classes_used, zend_op_array *op_array)
+{
+	uint64_t elapsed = zendump_time_ns() - start;
+	size_t usage = zend_memory_usage(0);
+	zendump_compile_site *site = zendump_compile_site_find(name, len, eval);
+
+	++site->count;
+	site->time += elapsed;
+	if(usage > memory) {
+		site->memory += usage - memory;
+	}
+	zendump_compile_count(functions_used, classes_used, op_array, site);
+}
+
+static zend_op_array *zendump_compile_file(zend_file_handle *file_handle, int type)
+{
+	uint32_t functions_used = CG(function_table)->nNumUsed, classes_used = CG(class_table)->nNumUsed;
+	size_t memory = zend_memory_usage(0);
+	uint64_t start = zendump_time_ns();
+	zend_op_array *op_array = ZENDUMP_G(origin_compile_file)(file_handle, type);
+	const char *name = (op_array && op_array->filename) ? ZSTR_VAL(op_array->filename) : file_handle->filename;
+
+	if(name) {
+		zendump_compile_record(name, strlen(name), 0, start, memory, functions_used, classes_used, op_array);
+	}
+	return op_array;
+}
+
+static zend_op_array *zendump_compile_string(zval *source_string, char *filename)
+{
+	uint32_t functions_used = CG(function_table)->nNumUsed, classes_used = CG(class_table)->nNumUsed;
+	size_t memory = zend_memory_usage(0);
+	uint64_t start = zendump_time_ns();
+	zend_op_array *op_array = ZENDUMP_G(origin_compile_string)(source_string, filename);
+
+	zendump_compile_record(filename, strlen(filename), 1, start, memory, functions_used, classes_used, op_array);
+	return op_array;
+}
+
+void zendump_compile_profile_startup()
+{
+	ZENDUMP_G(origin_compile_file) = zend_compile_file;
+	zend_compile_file = zendump_compile_file;
+	ZENDUMP_G(origin_compile_string) = zend_compile_string;
+	zend_compile_string = zendump_compile_string;
+}
+
+void zendump_compile_profile_shutdown()
+{
+	if(zend_compile_file == zendump_compile_file) {
+		zend_compile_file = ZENDUMP_G(origin_compile_file);
+	}
+	if(zend_compile_string == zendump_compile_string) {
+		zend_compile_string = ZENDUMP_G(origin_compile_string);
+	}
+}
+
+static int zendump_compile_site_compare(const void *a, const void *b)
+{
+	const zendump_compile_site *x = *(const zendump_compile_site**)a;
+	const zendump_compile_site *y = *(const zendump_compile_site**)b;
+	if(x->time != y->time) {
+		return x->time < y->time ? 1 : -1;
+	}
+	return 0;
+}
+
+void zendump_compile_profile_dump(zend_long limit)
+{
+	zendump_compile_site **sites = NULL, *site;
+	uint64_t total = 0;
+	uint32_t count = 0, idx;
+
+	if(ZENDUMP_G(compile_sites)) {
+		count = zend_hash_num_elements(ZENDUMP_G(compile_sites));
+	}
+	if(count) {
+		sites = safe_emalloc(count, sizeof(zendump_compile_site*), 0);
+		idx = 0;
+		ZEND_HASH_FOREACH_PTR(ZENDUMP_G(compile_sites), site) {
+			sites[idx++] = site;
+			total += site->time;
+		} ZEND_HASH_FOREACH_END();
+		qsort(sites, count, sizeof(zendump_compile_site*), zendump_compile_site_compare);
+	}
+	if(limit > 0 && limit < count) {
+		php_printf("compile(%u/%u) time(%" PRIu64 "ns): {\n", (uint32_t)limit, count, total);
+	} else {
+		php_printf("compile(%u) time(%" PRIu64 "ns): {\n", count, total);
+		limit = count;
+	}
+	for(idx = 0; idx < limit; ++idx) {
+		site = sites[idx];
+		php_printf("%*c%s %s count(%" PRIu64 ") time(%" PRIu64 "ns) memory(%" PRIu64 ") op_arrays(%" PRIu64 ") classes(%" PRIu64 ") opcodes(%" PRIu64 ")\n", INDENT_SIZE, ' ',
+			site->eval ? "eval" : "file", ZSTR_VAL(site->name), site->count, site->time, site->memory, site->op_arrays, site->classes, site->opcodes);
+	}
+	PUTS("}\n");
+	if(sites) {
+		efree(sites);
+	}
+}
+
+void zendump_compile_profile_reset()
+{
+	if(ZENDUMP_G(compile_sites)) {
+		zend_hash_destroy(ZENDUMP_G(compile_sites));
+		FREE_HASHTABLE(ZENDUMP_G(compile_sites));
+		ZENDUMP_G(compile_sites) = NULL;
+	}
+}
+
+static void zendump_isolated_function_dtor(zval *zv)
+{
+	zend_function *func = (zend_function*)Z_PTR_P(zv);
+	if(func->type == ZEND_USER_FUNCTION) {
+		destroy_op_array(&func->op_array);
+	}
+}
+
+static void zendump_isolated_class_dtor(zval *zv)
+{
+	zend_class_entry *ce = (zend_class_entry*)Z_PTR_P(zv);
+	if(ce->type == ZEND_USER_CLASS) {
+		destroy_zend_class(zv);
+	}
+}
+
+/* The internal functions and classes are shared with the isolated tables,
+   so the compiler still emits the same special opcodes and early binding
+   against internal parents, while the user declarations of the file can
+   neither clash with the running script nor leak into it. */
+void zendump_isolated_tables_init(HashTable *functions, HashTable *classes)
+{
+	zend_function *func;
+	zend_class_entry *ce;
+	zend_string *key;
+
+	zend_hash_init(functions, zend_hash_num_elements(CG(function_table)) + 64, NULL, zendump_isolated_function_dtor, 0);
+	zend_hash_init(classes, zend_hash_num_elements(CG(class_table)) + 16, NULL, zendump_isolated_class_dtor, 0);
+	ZEND_HASH_FOREACH_STR_KEY_PTR(CG(function_table), key, func) {
+		if(key && func->type == ZEND_INTERNAL_FUNCTION) {
+			zend_hash_add_new_ptr(functions, key, func);
+		}
+	} ZEND_HASH_FOREACH_END();
+	ZEND_HASH_FOREACH_STR_KEY_PTR(CG(class_table), key, ce) {
+		if(key && ce->type == ZEND_INTERNAL_CLASS) {
+			zend_hash_add_new_ptr(classes, key, ce);
+		}
+	} ZEND_HASH_FOREACH_END();
+}
+
+void zendump_isolated_tables_destroy(HashTable *functions, HashTable *classes)
+{
+	zend_hash_destroy(functions);
+	zend_hash_destroy(classes);
+}
+
+/* Opcache marks a script it loads from shared memory as included, which
+   would turn a later include_once of the file into a no-op. The entries
+   added since the count was taken are the last ones of the table. */
+static void zendump_included_files_restore(uint32_t count)
+{
+	HashTable *ht = &EG(included_files);
+	uint32_t idx = ht->nNumUsed;
+
+	while(zend_hash_num_elements(ht) > count && idx > 0) {
+		Bucket *p = ht->arData + --idx;
+		if(Z_TYPE(p->val) != IS_UNDEF) {
+			zend_hash_del_bucket(ht, p);
+		}
+	}
+}
+
+/* Compiles a file into the isolated tables, either with the bare Zend
+   compiler or through zend_compile_file, where opcache hooks its optimizer. */
+zend_op_array *zendump_compile_isolated(const char *filename, int raw, HashTable *functions, HashTable *classes)
+{
+	HashTable *orig_functions = CG(function_table), *orig_classes = CG(class_table);
+	HashTable *orig_eg_functions = EG(function_table), *orig_eg_classes = EG(class_table);
+	zend_op_array *orig_active_op_array = CG(active_op_array);
+	zend_class_entry *orig_active_class_entry = CG(active_class_entry);
+	zend_bool orig_in_compilation = CG(in_compilation);
+	zend_lex_state lex_state;
+	uint32_t included = zend_hash_num_elements(&EG(included_files));
+	zend_op_array *op_array = NULL;
+	zend_file_handle file_handle;
+	int bailout = 0;
+
+	memset(&file_handle, 0, sizeof(file_handle));
+	file_handle.type = ZEND_HANDLE_FILENAME;
+	file_handle.filename = filename;
+
+	CG(function_table) = functions;
+	CG(class_table) = classes;
+	zend_save_lexical_state(&lex_state);
+	zend_try {
+		op_array = raw ? compile_file(&file_handle, ZEND_INCLUDE) : zend_compile_file(&file_handle, ZEND_INCLUDE);
+	} zend_catch {
+		/* A compile error bails out of the middle of the compiler, which
+		   then restores neither its globals nor the scanner state. */
+		CG(active_op_array) = orig_active_op_array;
+		CG(active_class_entry) = orig_active_class_entry;
+		CG(in_compilation) = orig_in_compilation;
+		bailout = 1;
+	} zend_end_try();
+	zend_restore_lexical_state(&lex_state);
+	/* Opcache points the EG tables at the compiler ones while it loads a
+	   script and resets them to the isolated tables it saw on entry. */
+	CG(function_table) = orig_functions;
+	CG(class_table) = orig_classes;
+	EG(function_table) = orig_eg_functions;
+	EG(class_table) = orig_eg_classes;
+	zend_destroy_file_handle(&file_handle);
+	zendump_included_files_restore(included);
+
+	if(bailout) {
+		zend_bailout();
+	}
+	return op_array;
+}
+
+void zendump_isolated_op_array_free(zend_op_array *op_array)
+{
+	destroy_op_array(op_array);
+	efree(op_array);
+}
+
+static void zendump_optimizer_diff_op_array(zend_op_array *raw, zend_op_array *optimized)
+{
+	int32_t deltas[256] = {0};
+	uint32_t idx, changed = 0;
+
+	php_printf("%*c%s%s%s() opcodes(%u/%u) T(%u/%u) literals(%d/%d)", INDENT_SIZE, ' ',
+		raw->scope ? ZSTR_VAL(raw->scope->name) : "",
+		raw->scope ? "::" : "",
+		raw->function_name ? ZSTR_VAL(raw->function_name) : "{main}",
+		raw->last, optimized ? optimized->last : 0,
+		raw->T, optimized ? optimized->T : 0,
+		raw->last_literal, optimized ? optimized->last_literal : 0);
+	if(!optimized) {
+		PUTS(" missing\n");
+		return;
+	}
+	for(idx = 0; idx < raw->last; ++idx) {
+		--deltas[raw->opcodes[idx].opcode];
+	}
+	for(idx = 0; idx < optimized->last; ++idx) {
+		++deltas[optimized->opcodes[idx].opcode];
+	}
+	for(idx = 0; idx < ARRAY_LENGTH(deltas); ++idx) {
+		if(deltas[idx]) {
+			php_printf("%s%s(%+d)", changed++ ? " " : ": ", zend_get_opcode_name((zend_uchar)idx), deltas[idx]);
+		}
+	}
+	PUTS("\n");
+}
+
+static void zendump_optimizer_diff_methods(HashTable *raw, HashTable *optimized, zend_class_entry *scope)
+{
+	zend_function *func;
+	zend_string *key;
+
+	ZEND_HASH_FOREACH_STR_KEY_PTR(raw, key, func) {
+		zend_function *other = (key && optimized) ? zend_hash_find_ptr(optimized, key) : NULL;
+		if(func->type != ZEND_USER_FUNCTION || func->common.scope != scope) {
+			continue;
+		}
+		zendump_optimizer_diff_op_array(&func->op_array, (other && other->type == ZEND_USER_FUNCTION) ? &other->op_array : NULL);
+	} ZEND_HASH_FOREACH_END();
+}
+
+int zendump_optimizer_diff(const char *filename)
+{
+	HashTable raw_functions, raw_classes, optimized_functions, optimized_classes, optimized_names;
+	zend_op_array *raw, *optimized;
+	zend_class_entry *ce, *other;
+	zend_string *lcname;
+
+	if(zend_compile_file == compile_file) {
+		php_error_docref(NULL, E_WARNING, "No optimizer is hooked into zend_compile_file, enable opcache (opcache.enable_cli for the CLI)");
+		return FAILURE;
+	}
+
+	zendump_isolated_tables_init(&raw_functions, &raw_classes);
+	raw = zendump_compile_isolated(filename, 1, &raw_functions, &raw_classes);
+	if(!raw) {
+		zendump_isolated_tables_destroy(&raw_functions, &raw_classes);
+		return FAILURE;
+	}
+	zendump_isolated_tables_init(&optimized_functions, &optimized_classes);
+	optimized = zendump_compile_isolated(filename, 0, &optimized_functions, &optimized_classes);
+	if(!optimized) {
+		zendump_isolated_op_array_free(raw);
+		zendump_isolated_tables_destroy(&raw_functions, &raw_classes);
+		zendump_isolated_tables_destroy(&optimized_functions, &optimized_classes);
+		return FAILURE;
+	}
+
+	php_printf("optimizer_diff(%s) level(0x" ZEND_XLONG_FMT "): {\n", filename, zend_ini_long("opcache.optimization_level", sizeof("opcache.optimization_level") - 1, 0));
+	zendump_optimizer_diff_op_array(raw, optimized);
+	zendump_optimizer_diff_methods(&raw_functions, &optimized_functions, NULL);
+	/* Classes declared at run time are keyed by a name that embeds the
+	   address of the source, which differs between the two compilations. */
+	zend_hash_init(&optimized_names, 16, NULL, NULL, 0);
+	ZEND_HASH_FOREACH_PTR(&optimized_classes, other) {
+		if(other->type == ZEND_USER_CLASS) {
+			lcname = zend_string_tolower(other->name);
+			zend_hash_update_ptr(&optimized_names, lcname, other);
+			zend_string_release(lcname);
+		}
+	} ZEND_HASH_FOREACH_END();
+	ZEND_HASH_FOREACH_PTR(&raw_classes, ce) {
+		if(ce->type != ZEND_USER_CLASS) {
+			continue;
+		}
+		lcname = zend_string_tolower(ce->name);
+		other = zend_hash_find_ptr(&optimized_names, lcname);
+		zend_string_release(lcname);
+		zendump_optimizer_diff_methods(&ce->function_table, other ? &other->function_table : NULL, ce);
+	} ZEND_HASH_FOREACH_END();
+	zend_hash_destroy(&optimized_names);
+	PUTS("}\n");
+
+	zendump_isolated_op_array_free(raw);
+	zendump_isolated_op_array_free(optimized);
+	zendump_isolated_tables_destroy(&raw_functions, &raw_classes);
+	zendump_isolated_tables_destroy(&optimized_functions, &optimized_classes);
+	return SUCCESS;
+}
+
+static void zendump_file_dump_functions(HashTable *functions, zend_class_entry *scope, int column_width)
+{
+	zend_function *func;
+
+	ZEND_HASH_FOREACH_PTR(functions, func) {
+		if(func->type == ZEND_USER_FUNCTION && func->common.scope == scope) {
+			zendump_zend_function_dump(func, column_width);
+		}
+	} ZEND_HASH_FOREACH_END();
+}
+
+/* Compiles a file without executing it and dumps the main op_array, the
+   functions and the methods it declares. */
+int zendump_file_dump(const char *filename, int column_width)
+{
+	HashTable functions, classes;
+	zend_op_array *op_array;
+	zend_class_entry *ce;
+
+	zendump_isolated_tables_init(&functions, &classes);
+	zend_try {
+		op_array = zendump_compile_isolated(filename, 0, &functions, &classes);
+	} zend_catch {
+		zendump_isolated_tables_destroy(&functions, &classes);
+		zend_bailout();
+	} zend_end_try();
+	if(!op_array) {
+		zendump_isolated_tables_destroy(&functions, &classes);
+		return FAILURE;
+	}
+
+	php_printf("file(\"%s\")\n", filename);
+	zendump_zend_function_dump((zend_function*)op_array, column_width);
+	zendump_file_dump_functions(&functions, NULL, column_width);
+	ZEND_HASH_FOREACH_PTR(&classes, ce) {
+		if(ce->type == ZEND_USER_CLASS) {
+			zendump_file_dump_functions(&ce->function_table, ce, column_width);
+		}
+	} ZEND_HASH_FOREACH_END();
+
+	zendump_isolated_op_array_free(op_array);
+	zendump_isolated_tables_destroy(&functions, &classes);
+	return SUCCESS;
+}
+
+static int zendump_file_name_compare(const void *a, const void *b)
+{
+	Bucket *f = (Bucket*)a;
+	Bucket *s = (Bucket*)b;
+
+	return zend_binary_strcmp(ZSTR_VAL(f->key), ZSTR_LEN(f->key), ZSTR_VAL(s->key), ZSTR_LEN(s->key));
+}
+
+/* Collects the .php files below a directory, symlinked directories are not
+   followed so a link cycle can not make the walk endless. */
+static void zendump_file_collect(const char *path, HashTable *files)
+{
+	php_stream *dir;
+	php_stream_dirent entry;
+	php_stream_statbuf ssb;
+	zend_string *child;
+	size_t len;
+
+	if(php_stream_stat_path_ex(path, PHP_STREAM_URL_STAT_LINK, &ssb, NULL) != 0) {
+		return;
+	}
+	if(!S_ISDIR(ssb.sb.st_mode)) {
+		len = strlen(path);
+		if(len > 4 && !strcmp(path + len - 4, ".php")) {
+			zend_hash_str_add_empty_element(files, path, len);
+		}
+		return;
+	}
+
+	dir = php_stream_opendir(path, REPORT_ERRORS, NULL);
+	if(!dir) {
+		return;
+	}
+	while(php_stream_readdir(dir, &entry)) {
+		if(!strcmp(entry.d_name, ".") || !strcmp(entry.d_name, "..")) {
+			continue;
+		}
+		child = strpprintf(0, "%s%c%s", path, DEFAULT_SLASH, entry.d_name);
+		zendump_file_collect(ZSTR_VAL(child), files);
+		zend_string_release(child);
+	}
+	php_stream_closedir(dir);
+}
+
+/* Disassembles a file or every .php file below a directory into a single
+   output file. The sections are written as they are produced and an index
+   of their offsets and lengths follows them, its own offset is on the last
+   line so readers can seek to any file without scanning the dump. A file
+   with a compile error is reported as failed and the batch goes on, though
+   PHP has already marked the live objects as destructed at that point. */
+zend_long zendump_file_batch(const char *path, const char *output, int column_width)
+{
+	HashTable files, offsets;
+	php_stream *stream;
+	zend_string *name;
+	zend_off_t start, index;
+	zend_long count = 0;
+	zval contents, entry;
+	int exit_status = EG(exit_status), dumped;
+
+	stream = php_stream_open_wrapper((char*)output, "wb", REPORT_ERRORS, NULL);
+	if(!stream) {
+		return -1;
+	}
+
+	zend_hash_init(&files, 64, NULL, NULL, 0);
+	zend_hash_init(&offsets, 64, NULL, NULL, 0);
+	zendump_file_collect(path, &files);
+	zend_hash_sort(&files, zendump_file_name_compare, 0);
+
+	ZEND_HASH_FOREACH_STR_KEY(&files, name) {
+		if(php_output_start_default() != SUCCESS) {
+			break;
+		}
+		zend_try {
+			dumped = zendump_file_dump(ZSTR_VAL(name), column_width);
+		} zend_catch {
+			EG(exit_status) = exit_status;
+			dumped = FAILURE;
+		} zend_end_try();
+		if(dumped == SUCCESS && php_output_get_contents(&contents) == SUCCESS) {
+			start = php_stream_tell(stream);
+			php_stream_write(stream, Z_STRVAL(contents), Z_STRLEN(contents));
+			ZVAL_LONG(&entry, (zend_long)start);
+			zend_hash_add(&offsets, name, &entry);
+			zval_dtor(&contents);
+			++count;
+		} else if(EG(exception)) {
+			zend_clear_exception();
+		}
+		php_output_discard();
+	} ZEND_HASH_FOREACH_END();
+
+	index = php_stream_tell(stream);
+	php_stream_printf(stream, "index(%u/%u): {\n", zend_hash_num_elements(&offsets), zend_hash_num_elements(&files));
+	ZEND_HASH_FOREACH_STR_KEY(&files, name) {
+		zval *offset = zend_hash_find(&offsets, name);
+		if(offset) {
+			php_stream_printf(stream, "%*c" ZEND_LONG_FMT " %s\n", INDENT_SIZE, ' ', Z_LVAL_P(offset), ZSTR_VAL(name));
+		} else {
+			php_stream_printf(stream, "%*cfailed %s\n", INDENT_SIZE, ' ', ZSTR_VAL(name));
+		}
+	} ZEND_HASH_FOREACH_END();
+	php_stream_printf(stream, "}\nindex_offset(" ZEND_LONG_FMT ")\n", (zend_long)index);
+	php_stream_close(stream);
+
+	zend_hash_destroy(&offsets);
+	zend_hash_destroy(&files);
+	return count;
+}
@@ -59,5 +59,7 @@ if test "$PHP_ZENDUMP" != "no"; then
   dnl
   dnl PHP_SUBST(ZENDUMP_SHARED_LIBADD)
 
-  PHP_NEW_EXTENSION(zendump, zendump.c function_dump.c class_dump.c utility.c trace.c, $ext_shared,, -DZEND_ENABLE_STATIC_TSRMLS_CACHE=1)
+  PHP_CHECK_FUNC(timer_create, rt)
+
+  PHP_NEW_EXTENSION(zendump, zendump.c function_dump.c class_dump.c utility.c trace.c heap_dump.c profile.c cfg.c coverage.c compile.c runtime.c preload.c cache.c types.c gc.c errors.c watchdog.c backtrace.c diff.c, $ext_shared,, -DZEND_ENABLE_STATIC_TSRMLS_CACHE=1)
 fi
@@ -0,0 +1,197 @@
+/*
+  +----------------------------------------------------------------------+
+  | PHP Version 7                                                        |
+  +----------------------------------------------------------------------+
+  | Copyright (c) 1997-2018 The PHP Group                                |
+  +----------------------------------------------------------------------+
+  | This source file is subject to version 3.01 of the PHP license,      |
+  | that is bundled with this package in the file LICENSE, and is        |
+  | available through the world-wide-web at the following url:           |
+  | http://www.php.net/license/3_01.txt                                  |
+  | If you did not receive a copy of the PHP license and are unable to   |
+  | obtain it through the world-wide-web, please send a note to          |
+  | license@php.net so we can mail you a copy immediately.               |
+  +----------------------------------------------------------------------+
+  | Author: Youlin Feng <fengyoulin@php7th.com>                          |
+  +----------------------------------------------------------------------+
+*/
+
+/* $Id$ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "php.h"
+#include "php_ini.h"
+#include "ext/standard/info.h"
+#include "php_zendump.h"
+
+ZEND_EXTERN_MODULE_GLOBALS(zendump)
+
+#define COVERAGE_BIT_SET(bits, num) ((bits)[(num) >> 3] |= (zend_uchar)(1 << ((num) & 7)))
+#define COVERAGE_BIT_GET(bits, num) ((bits)[(num) >> 3] & (1 << ((num) & 7)))
+
+static int zendump_coverage_executable(const zend_op *opline)
+{
+	switch(opline->opcode) {
+		case ZEND_NOP:
+		case ZEND_EXT_NOP:
+		case ZEND_EXT_STMT:
+		case ZEND_EXT_FCALL_BEGIN:
+		case ZEND_EXT_FCALL_END:
+			return 0;
+	}
+	return opline->lineno != 0;
+}
+
+static void zendump_coverage_alloc(zendump_op_array_profile *profile, zend_op_array *op_array)
+{
+	uint32_t idx, line_end = 0;
+
+	profile->coverage = ecalloc((op_array->last + 7) >> 3, 1);
+	profile->coverage_line_start = op_array->opcodes[0].lineno;
+	for(idx = 0; idx < op_array->last; ++idx) {
+		if(op_array->opcodes[idx].lineno < profile->coverage_line_start) {
+			profile->coverage_line_start = op_array->opcodes[idx].lineno;
+		}
+		if(op_array->opcodes[idx].lineno > line_end) {
+			line_end = op_array->opcodes[idx].lineno;
+		}
+	}
+	profile->coverage_line_count = line_end - profile->coverage_line_start + 1;
+	profile->coverage_lines = ecalloc((profile->coverage_line_count + 7) >> 3, 1);
+	profile->coverage_executable = ecalloc((profile->coverage_line_count + 7) >> 3, 1);
+	for(idx = 0; idx < op_array->last; ++idx) {
+		if(zendump_coverage_executable(op_array->opcodes + idx)) {
+			COVERAGE_BIT_SET(profile->coverage_executable, op_array->opcodes[idx].lineno - profile->coverage_line_start);
+		}
+	}
+}
+
+/* Only the first execution of an opline touches the line bitmap, every
+   later one costs a profile lookup and a bit test. The executable lines are
+   captured up front because included files free their op_array early. */
+void zendump_coverage_observe(zend_execute_data *execute_data, const zend_op *opline)
+{
+	zend_op_array *op_array = &EX(func)->op_array;
+	zendump_op_array_profile *profile;
+	uint32_t num = opline - op_array->opcodes;
+
+	if(!ZENDUMP_G(coverage_active) || num >= op_array->last) {
+		return;
+	}
+	profile = zendump_profile_find(op_array, 1);
+	if(!profile->coverage) {
+		zendump_coverage_alloc(profile, op_array);
+	}
+	if(num < profile->last && !COVERAGE_BIT_GET(profile->coverage, num)) {
+		COVERAGE_BIT_SET(profile->coverage, num);
+		if(zendump_coverage_executable(opline) && opline->lineno - profile->coverage_line_start < profile->coverage_line_count) {
+			COVERAGE_BIT_SET(profile->coverage_lines, opline->lineno - profile->coverage_line_start);
+		}
+	}
+}
+
+void zendump_coverage_start()
+{
+	zendump_op_array_profile *profile;
+
+	if(ZENDUMP_G(profiles)) {
+		ZEND_HASH_FOREACH_PTR(ZENDUMP_G(profiles), profile) {
+			if(profile->coverage) {
+				memset(profile->coverage, 0, (profile->last + 7) >> 3);
+				memset(profile->coverage_lines, 0, (profile->coverage_line_count + 7) >> 3);
+			}
+		} ZEND_HASH_FOREACH_END();
+	}
+	ZENDUMP_G(coverage_active) = 1;
+}
+
+static void zendump_coverage_add_unexecuted(zval *result, zend_function *func)
+{
+	zend_op_array *op_array;
+	zval *file, *line, entry;
+	uint32_t idx;
+
+	if(func->type != ZEND_USER_FUNCTION || !func->op_array.filename) {
+		return;
+	}
+	op_array = &func->op_array;
+	file = zend_hash_find(Z_ARRVAL_P(result), op_array->filename);
+	if(!file) {
+		return;
+	}
+	for(idx = 0; idx < op_array->last; ++idx) {
+		if(!zendump_coverage_executable(op_array->opcodes + idx)) {
+			continue;
+		}
+		line = zend_hash_index_find(Z_ARRVAL_P(file), op_array->opcodes[idx].lineno);
+		if(!line) {
+			ZVAL_LONG(&entry, -1);
+			zend_hash_index_add_new(Z_ARRVAL_P(file), op_array->opcodes[idx].lineno, &entry);
+		}
+	}
+}
+
+static int zendump_coverage_line_compare(const void *a, const void *b)
+{
+	zend_ulong x = ((const Bucket*)a)->h, y = ((const Bucket*)b)->h;
+	return x < y ? -1 : (x > y ? 1 : 0);
+}
+
+void zendump_coverage_stop(zval *result)
+{
+	zendump_op_array_profile *profile;
+	zend_class_entry *ce;
+	zend_function *func;
+	zval *file, *line, entry;
+	uint32_t idx;
+
+	ZENDUMP_G(coverage_active) = 0;
+
+	array_init(result);
+	if(!ZENDUMP_G(profiles)) {
+		return;
+	}
+	ZEND_HASH_FOREACH_PTR(ZENDUMP_G(profiles), profile) {
+		if(!profile->coverage || !profile->filename) {
+			continue;
+		}
+		file = zend_hash_find(Z_ARRVAL_P(result), profile->filename);
+		if(!file) {
+			array_init(&entry);
+			file = zend_hash_add_new(Z_ARRVAL_P(result), profile->filename, &entry);
+		}
+		for(idx = 0; idx < profile->coverage_line_count; ++idx) {
+			if(!COVERAGE_BIT_GET(profile->coverage_executable, idx)) {
+				continue;
+			}
+			line = zend_hash_index_find(Z_ARRVAL_P(file), profile->coverage_line_start + idx);
+			if(!line) {
+				ZVAL_LONG(&entry, COVERAGE_BIT_GET(profile->coverage_lines, idx) ? 1 : -1);
+				zend_hash_index_add_new(Z_ARRVAL_P(file), profile->coverage_line_start + idx, &entry);
+			} else if(COVERAGE_BIT_GET(profile->coverage_lines, idx)) {
+				ZVAL_LONG(line, 1);
+			}
+		}
+	} ZEND_HASH_FOREACH_END();
+
+	ZEND_HASH_FOREACH_PTR(EG(function_table), func) {
+		zendump_coverage_add_unexecuted(result, func);
+	} ZEND_HASH_FOREACH_END();
+	ZEND_HASH_FOREACH_PTR(EG(class_table), ce) {
+		if(ce->type != ZEND_USER_CLASS) {
+			continue;
+		}
+		ZEND_HASH_FOREACH_PTR(&ce->function_table, func) {
+			if(func->common.scope == ce) {
+				zendump_coverage_add_unexecuted(result, func);
+			}
+		} ZEND_HASH_FOREACH_END();
+	} ZEND_HASH_FOREACH_END();
+
+	ZEND_HASH_FOREACH_VAL(Z_ARRVAL_P(result), file) {
+		zend_hash_sort(Z_ARRVAL_P(file), zendump_coverage_line_compare, 0);
+	} ZEND_HASH_FOREACH_END();
+}
@@ -0,0 +1,253 @@
+/*
+  +----------------------------------------------------------------------+
+  | PHP Version 7                                                        |
+  +----------------------------------------------------------------------+
+  | Copyright (c) 1997-2018 The PHP Group                                |
+  +----------------------------------------------------------------------+
+  | This source file is subject to version 3.01 of the PHP license,      |
+  | that is bundled with this package in the file LICENSE, and is        |
+  | available through the world-wide-web at the following url:           |
+  | http://www.php.net/license/3_01.txt                                  |
+  | If you did not receive a copy of the PHP license and are unable to   |
+  | obtain it through the world-wide-web, please send a note to          |
+  | license@php.net so we can mail you a copy immediately.               |
+  +----------------------------------------------------------------------+
+  | Author: Youlin Feng <fengyoulin@php7th.com>                          |
+  +----------------------------------------------------------------------+
+*/
+
+/* $Id$ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "php.h"
+#include "php_ini.h"
+#include "ext/standard/info.h"
+#include "php_zendump.h"
+#include "zend_smart_str.h"
+
+#define DIFF_MAX_DEPTH 256
+
+typedef struct _zendump_diff_context {
+	smart_str path;
+	smart_str out;
+	HashTable visited;
+	zend_long limit;
+	zend_long count;
+} zendump_diff_context;
+
+static void zendump_diff_value(zendump_diff_context *ctx, zval *a, zval *b, uint32_t depth);
+
+static void zendump_diff_report(zendump_diff_context *ctx, const char *what, zval *a, zval *b)
+{
+	++ctx->count;
+	smart_str_appendl(&ctx->out, "  ", INDENT_SIZE);
+	if(ctx->path.s) {
+		smart_str_append(&ctx->out, ctx->path.s);
+	}
+	smart_str_appends(&ctx->out, ": ");
+	if(what) {
+		smart_str_appends(&ctx->out, what);
+		if(a || b) {
+			smart_str_appendc(&ctx->out, ' ');
+		}
+	}
+	if(a) {
+		zendump_zval_summary_append(&ctx->out, a);
+	}
+	if(a && b) {
+		smart_str_appends(&ctx->out, " => ");
+	}
+	if(b) {
+		zendump_zval_summary_append(&ctx->out, b);
+	}
+	smart_str_appendc(&ctx->out, '\n');
+}
+
+static void zendump_diff_key(zendump_diff_context *ctx, zend_string *key, zend_ulong h, zend_bool property)
+{
+	if(property) {
+		const char *class_name, *prop_name;
+		size_t prop_len;
+		smart_str_appends(&ctx->path, "->");
+		if(key) {
+			zend_unmangle_property_name_ex(key, &class_name, &prop_name, &prop_len);
+			smart_str_appendl(&ctx->path, prop_name, prop_len);
+		} else {
+			smart_str_append_unsigned(&ctx->path, h);
+		}
+		return;
+	}
+	smart_str_appendc(&ctx->path, '[');
+	if(key) {
+		smart_str_appendc(&ctx->path, '"');
+		smart_str_append(&ctx->path, key);
+		smart_str_appendc(&ctx->path, '"');
+	} else {
+		smart_str_append_long(&ctx->path, (zend_long)h);
+	}
+	smart_str_appendc(&ctx->path, ']');
+}
+
+/* Walks the keys of the old table first, so changed and removed entries
+   keep its order, then the keys that only exist in the new one. */
+static void zendump_diff_table(zendump_diff_context *ctx, HashTable *a, HashTable *b, zend_bool property, uint32_t depth)
+{
+	size_t mark = ctx->path.s ? ZSTR_LEN(ctx->path.s) : 0;
+	zend_string *key;
+	zend_ulong h;
+	zval *val, *other;
+
+	ZEND_HASH_FOREACH_KEY_VAL_IND(a, h, key, val) {
+		if(ctx->limit > 0 && ctx->count >= ctx->limit) {
+			return;
+		}
+		other = key ? zend_hash_find(b, key) : zend_hash_index_find(b, h);
+		if(other && Z_TYPE_P(other) == IS_INDIRECT) {
+			other = Z_INDIRECT_P(other);
+		}
+		zendump_diff_key(ctx, key, h, property);
+		if(!other || Z_TYPE_P(other) == IS_UNDEF) {
+			zendump_diff_report(ctx, "removed", val, NULL);
+		} else {
+			zendump_diff_value(ctx, val, other, depth + 1);
+		}
+		ZSTR_LEN(ctx->path.s) = mark;
+	} ZEND_HASH_FOREACH_END();
+
+	ZEND_HASH_FOREACH_KEY_VAL_IND(b, h, key, val) {
+		if(ctx->limit > 0 && ctx->count >= ctx->limit) {
+			return;
+		}
+		other = key ? zend_hash_find(a, key) : zend_hash_index_find(a, h);
+		if(other && Z_TYPE_P(other) == IS_INDIRECT) {
+			other = Z_INDIRECT_P(other);
+		}
+		if(!other || Z_TYPE_P(other) == IS_UNDEF) {
+			zendump_diff_key(ctx, key, h, property);
+			zendump_diff_report(ctx, "added", NULL, val);
+			ZSTR_LEN(ctx->path.s) = mark;
+		}
+	} ZEND_HASH_FOREACH_END();
+}
+
+/* Anything both sides share by address, which copy-on-write and interning
+   make the common case, is equal without being looked at, so the cost is
+   proportional to what actually differs. */
+static void zendump_diff_value(zendump_diff_context *ctx, zval *a, zval *b, uint32_t depth)
+{
+	if(ctx->limit > 0 && ctx->count >= ctx->limit) {
+		return;
+	}
+	ZVAL_DEREF(a);
+	ZVAL_DEREF(b);
+	if(Z_TYPE_P(a) != Z_TYPE_P(b)) {
+		zendump_diff_report(ctx, NULL, a, b);
+		return;
+	}
+	if(depth > DIFF_MAX_DEPTH) {
+		zendump_diff_report(ctx, "too deep", NULL, NULL);
+		return;
+	}
+	switch(Z_TYPE_P(a)) {
+		case IS_LONG:
+			if(Z_LVAL_P(a) != Z_LVAL_P(b)) {
+				zendump_diff_report(ctx, NULL, a, b);
+			}
+			break;
+		case IS_DOUBLE:
+			if(memcmp(&Z_DVAL_P(a), &Z_DVAL_P(b), sizeof(double))) {
+				zendump_diff_report(ctx, NULL, a, b);
+			}
+			break;
+		case IS_STRING:
+			if(Z_STR_P(a) != Z_STR_P(b) && !zend_string_equals(Z_STR_P(a), Z_STR_P(b))) {
+				zendump_diff_report(ctx, NULL, a, b);
+			}
+			break;
+		case IS_ARRAY: {
+			HashTable *ha = Z_ARRVAL_P(a), *hb = Z_ARRVAL_P(b);
+			if(ha == hb) {
+				break;
+			}
+			/* References can make an array contain itself, an array that
+			   is already being walked is not entered again. */
+			if((ZEND_HASH_APPLY_PROTECTION(ha) && ha->u.v.nApplyCount > 0) || (ZEND_HASH_APPLY_PROTECTION(hb) && hb->u.v.nApplyCount > 0)) {
+				zendump_diff_report(ctx, "recursive", NULL, NULL);
+				break;
+			}
+			if(ZEND_HASH_APPLY_PROTECTION(ha)) {
+				++ha->u.v.nApplyCount;
+			}
+			if(ZEND_HASH_APPLY_PROTECTION(hb)) {
+				++hb->u.v.nApplyCount;
+			}
+			zendump_diff_table(ctx, ha, hb, 0, depth);
+			if(ZEND_HASH_APPLY_PROTECTION(ha)) {
+				--ha->u.v.nApplyCount;
+			}
+			if(ZEND_HASH_APPLY_PROTECTION(hb)) {
+				--hb->u.v.nApplyCount;
+			}
+			break;
+		}
+		case IS_OBJECT: {
+			HashTable *pa, *pb;
+			zval *seen, pair;
+			if(Z_OBJ_P(a) == Z_OBJ_P(b)) {
+				break;
+			}
+			if(Z_OBJCE_P(a) != Z_OBJCE_P(b)) {
+				zendump_diff_report(ctx, NULL, a, b);
+				break;
+			}
+			/* Object graphs may be cyclic, every pair is compared once. */
+			seen = zend_hash_index_find(&ctx->visited, Z_OBJ_HANDLE_P(a));
+			if(seen && Z_LVAL_P(seen) == Z_OBJ_HANDLE_P(b)) {
+				break;
+			}
+			ZVAL_LONG(&pair, Z_OBJ_HANDLE_P(b));
+			zend_hash_index_update(&ctx->visited, Z_OBJ_HANDLE_P(a), &pair);
+			pa = Z_OBJ_HT_P(a)->get_properties ? Z_OBJPROP_P(a) : NULL;
+			pb = Z_OBJ_HT_P(b)->get_properties ? Z_OBJPROP_P(b) : NULL;
+			if(pa && pb && pa != pb) {
+				zendump_diff_table(ctx, pa, pb, 1, depth);
+			}
+			break;
+		}
+		case IS_RESOURCE:
+			if(Z_RES_P(a) != Z_RES_P(b)) {
+				zendump_diff_report(ctx, NULL, a, b);
+			}
+			break;
+	}
+}
+
+zend_long zendump_diff(zval *a, zval *b, zend_long limit)
+{
+	zendump_diff_context ctx;
+
+	memset(&ctx, 0, sizeof(ctx));
+	ctx.limit = limit;
+	zend_hash_init(&ctx.visited, 16, NULL, NULL, 0);
+	smart_str_appendc(&ctx.path, '$');
+
+	zendump_diff_value(&ctx, a, b, 0);
+
+	if(limit > 0 && ctx.count >= limit) {
+		php_printf("diff(" ZEND_LONG_FMT "+): {\n", ctx.count);
+	} else {
+		php_printf("diff(" ZEND_LONG_FMT "): {\n", ctx.count);
+	}
+	if(ctx.out.s) {
+		PHPWRITE(ZSTR_VAL(ctx.out.s), ZSTR_LEN(ctx.out.s));
+	}
+	PUTS("}\n");
+
+	smart_str_free(&ctx.path);
+	smart_str_free(&ctx.out);
+	zend_hash_destroy(&ctx.visited);
+	return ctx.count;
+}
@@ -0,0 +1,308 @@
+/*
+  +----------------------------------------------------------------------+
+  | PHP Version 7                                                        |
+  +----------------------------------------------------------------------+
+  | Copyright (c) 1997-2018 The PHP Group                                |
+  +----------------------------------------------------------------------+
+  | This source file is subject to version 3.01 of the PHP license,      |
+  | that is bundled with this package in the file LICENSE, and is        |
+  | available through the world-wide-web at the following url:           |
+  | http://www.php.net/license/3_01.txt                                  |
+  | If you did not receive a copy of the PHP license and are unable to   |
+  | obtain it through the world-wide-web, please send a note to          |
+  | license@php.net so we can mail you a copy immediately.               |
+  +----------------------------------------------------------------------+
+  | Author: Youlin Feng <fengyoulin@php7th.com>                          |
+  +----------------------------------------------------------------------+
+*/
+
+/* $Id$ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "php.h"
+#include "php_ini.h"
+#include "ext/standard/info.h"
+#include "php_zendump.h"
+#include "zend_exceptions.h"
+
+ZEND_EXTERN_MODULE_GLOBALS(zendump)
+
+typedef struct _zendump_error_site {
+	uint64_t count;
+	uint64_t thrown;
+	uint64_t suppressed;
+	uint64_t time;
+} zendump_error_site;
+
+typedef zend_object *(*zendump_create_object_t)(zend_class_entry *class_type);
+
+static void zendump_error_site_dtor(zval *zv)
+{
+	efree(Z_PTR_P(zv));
+}
+
+static const char *zendump_error_type_name(int type)
+{
+	switch(type & E_ALL) {
+		case E_ERROR:             return "E_ERROR";
+		case E_WARNING:           return "E_WARNING";
+		case E_PARSE:             return "E_PARSE";
+		case E_NOTICE:            return "E_NOTICE";
+		case E_CORE_ERROR:        return "E_CORE_ERROR";
+		case E_CORE_WARNING:      return "E_CORE_WARNING";
+		case E_COMPILE_ERROR:     return "E_COMPILE_ERROR";
+		case E_COMPILE_WARNING:   return "E_COMPILE_WARNING";
+		case E_USER_ERROR:        return "E_USER_ERROR";
+		case E_USER_WARNING:      return "E_USER_WARNING";
+		case E_USER_NOTICE:       return "E_USER_NOTICE";
+		case E_STRICT:            return "E_STRICT";
+		case E_RECOVERABLE_ERROR: return "E_RECOVERABLE_ERROR";
+		case E_DEPRECATED:        return "E_DEPRECATED";
+		case E_USER_DEPRECATED:   return "E_USER_DEPRECATED";
+	}
+	return "E_UNKNOWN";
+}
+
+/* Exceptions are keyed by the user code that was running when they were
+   created, so the ones raised inside internal functions are charged to the
+   calling line. */
+static zend_string *zendump_exception_site(zend_class_entry *ce)
+{
+	zend_execute_data *ex = EG(current_execute_data);
+
+	while(ex && (!ex->func || !ZEND_USER_CODE(ex->func->type))) {
+		ex = ex->prev_execute_data;
+	}
+	if(!ex) {
+		return strpprintf(0, "%s [internal]", ZSTR_VAL(ce->name));
+	}
+	return strpprintf(0, "%s %s:%u", ZSTR_VAL(ce->name), ZSTR_VAL(ex->func->op_array.filename), ex->opline ? ex->opline->lineno : 0);
+}
+
+static void zendump_error_site_add(zendump_error_site *site, uint64_t count, uint64_t thrown, uint64_t suppressed, uint64_t time)
+{
+	site->count += count;
+	site->thrown += thrown;
+	site->suppressed += suppressed;
+	site->time += time;
+}
+
+static void zendump_error_record(zend_string *key, uint64_t count, uint64_t thrown, uint64_t suppressed, uint64_t time)
+{
+	zendump_error_site *site;
+
+	if(!ZENDUMP_G(error_sites)) {
+		ALLOC_HASHTABLE(ZENDUMP_G(error_sites));
+		zend_hash_init(ZENDUMP_G(error_sites), 32, NULL, zendump_error_site_dtor, 0);
+	}
+	site = zend_hash_find_ptr(ZENDUMP_G(error_sites), key);
+	if(!site) {
+		site = ecalloc(1, sizeof(zendump_error_site));
+		zend_hash_add_new_ptr(ZENDUMP_G(error_sites), key, site);
+	}
+	zendump_error_site_add(site, count, thrown, suppressed, time);
+	site = zendump_pool_record(&ZENDUMP_G(error_pool), ZSTR_VAL(key), ZSTR_LEN(key), sizeof(zendump_error_site), NULL);
+	zendump_error_site_add(site, count, thrown, suppressed, time);
+}
+
+static zendump_create_object_t zendump_exception_origin(zend_class_entry *ce)
+{
+	zendump_create_object_t origin;
+
+	for(; ce; ce = ce->parent) {
+		origin = (zendump_create_object_t)zend_hash_index_find_ptr(ZENDUMP_G(exception_origins), (zend_ulong)(zend_uintptr_t)ce);
+		if(origin) {
+			return origin;
+		}
+	}
+	return NULL;
+}
+
+/* The default create_object handlers of the throwables collect the
+   backtrace, which is the expensive part of building an exception. User
+   classes inherit the wrapped handler, the original one is looked up from
+   the nearest internal ancestor. */
+static zend_object *zendump_exception_new(zend_class_entry *class_type)
+{
+	zendump_create_object_t origin = zendump_exception_origin(class_type);
+	zend_string *key;
+	zend_object *object;
+	uint64_t start, elapsed;
+
+	if(!ZENDUMP_G(error_recording)) {
+		return origin(class_type);
+	}
+	start = zendump_time_ns();
+	object = origin(class_type);
+	elapsed = zendump_time_ns() - start;
+
+	key = zendump_exception_site(class_type);
+	zendump_error_record(key, 1, 0, 0, elapsed);
+	zend_string_release(key);
+	return object;
+}
+
+static void zendump_throw_exception_hook(zval *ex)
+{
+	zend_string *key;
+
+	/* zend_throw_exception_internal(NULL) rethrows a pending exception, for
+	   example after a callback threw, and passes NULL to the hook. */
+	if(ZENDUMP_G(error_recording) && ex && Z_TYPE_P(ex) == IS_OBJECT) {
+		key = zendump_exception_site(Z_OBJCE_P(ex));
+		zendump_error_record(key, 0, 1, 0, 0);
+		zend_string_release(key);
+	}
+	if(ZENDUMP_G(origin_throw_exception_hook)) {
+		ZENDUMP_G(origin_throw_exception_hook)(ex);
+	}
+}
+
+/* The error callback formats the message even when error_reporting or the
+   @ operator hides it, so suppressed errors are timed the same way. */
+static void zendump_error_cb(int type, const char *error_filename, const uint32_t error_lineno, const char *format, va_list args)
+{
+	zend_string *key;
+	zend_bool suppressed;
+	uint64_t start;
+
+	if(!ZENDUMP_G(error_recording)) {
+		ZENDUMP_G(origin_error_cb)(type, error_filename, error_lineno, format, args);
+		return;
+	}
+	suppressed = !(EG(error_reporting) & type);
+	key = strpprintf(0, "%s %s:%u", zendump_error_type_name(type), error_filename ? error_filename : "[no file]", error_lineno);
+	start = zendump_time_ns();
+	zend_try {
+		ZENDUMP_G(origin_error_cb)(type, error_filename, error_lineno, format, args);
+	} zend_catch {
+		zendump_error_record(key, 1, 0, suppressed, zendump_time_ns() - start);
+		zend_string_release(key);
+		zend_bailout();
+	} zend_end_try();
+	zendump_error_record(key, 1, 0, suppressed, zendump_time_ns() - start);
+	zend_string_release(key);
+}
+
+void zendump_error_trace_startup()
+{
+	zend_class_entry *ce;
+
+	ZENDUMP_G(exception_origins) = pemalloc(sizeof(HashTable), 1);
+	zend_hash_init(ZENDUMP_G(exception_origins), 32, NULL, NULL, 1);
+	ZEND_HASH_FOREACH_PTR(CG(class_table), ce) {
+		if(ce->type == ZEND_INTERNAL_CLASS && ce->create_object && instanceof_function(ce, zend_ce_throwable)) {
+			zend_hash_index_add_new_ptr(ZENDUMP_G(exception_origins), (zend_ulong)(zend_uintptr_t)ce, (void*)ce->create_object);
+			ce->create_object = zendump_exception_new;
+		}
+	} ZEND_HASH_FOREACH_END();
+
+	ZENDUMP_G(origin_throw_exception_hook) = zend_throw_exception_hook;
+	zend_throw_exception_hook = zendump_throw_exception_hook;
+	ZENDUMP_G(origin_error_cb) = zend_error_cb;
+	zend_error_cb = zendump_error_cb;
+}
+
+void zendump_error_trace_shutdown()
+{
+	zend_class_entry *ce;
+
+	if(zend_error_cb == zendump_error_cb) {
+		zend_error_cb = ZENDUMP_G(origin_error_cb);
+	}
+	if(zend_throw_exception_hook == zendump_throw_exception_hook) {
+		zend_throw_exception_hook = ZENDUMP_G(origin_throw_exception_hook);
+	}
+	if(ZENDUMP_G(exception_origins)) {
+		ZEND_HASH_FOREACH_PTR(CG(class_table), ce) {
+			if(ce->type == ZEND_INTERNAL_CLASS && ce->create_object == zendump_exception_new) {
+				ce->create_object = (zendump_create_object_t)zend_hash_index_find_ptr(ZENDUMP_G(exception_origins), (zend_ulong)(zend_uintptr_t)ce);
+			}
+		} ZEND_HASH_FOREACH_END();
+		zend_hash_destroy(ZENDUMP_G(exception_origins));
+		pefree(ZENDUMP_G(exception_origins), 1);
+		ZENDUMP_G(exception_origins) = NULL;
+	}
+	zendump_pool_destroy(&ZENDUMP_G(error_pool));
+}
+
+typedef struct _zendump_error_entry {
+	zend_string        *name;
+	zendump_error_site *site;
+} zendump_error_entry;
+
+static int zendump_error_entry_compare(const void *a, const void *b)
+{
+	const zendump_error_site *x = ((const zendump_error_entry*)a)->site;
+	const zendump_error_site *y = ((const zendump_error_entry*)b)->site;
+	if(x->time != y->time) {
+		return x->time < y->time ? 1 : -1;
+	}
+	if(x->count != y->count) {
+		return x->count < y->count ? 1 : -1;
+	}
+	return 0;
+}
+
+void zendump_error_trace_dump(zend_long limit, zend_bool pool)
+{
+	HashTable *sites = pool ? ZENDUMP_G(error_pool) : ZENDUMP_G(error_sites);
+	zendump_error_entry *entries = NULL;
+	zendump_error_site *site;
+	zend_string *name;
+	uint64_t time = 0, count = 0, thrown = 0;
+	uint32_t total = 0, idx;
+
+	if(sites) {
+		total = zend_hash_num_elements(sites);
+	}
+	if(total) {
+		entries = safe_emalloc(total, sizeof(zendump_error_entry), 0);
+		idx = 0;
+		ZEND_HASH_FOREACH_STR_KEY_PTR(sites, name, site) {
+			entries[idx].name = name;
+			entries[idx].site = site;
+			time += site->time;
+			count += site->count;
+			thrown += site->thrown;
+			++idx;
+		} ZEND_HASH_FOREACH_END();
+		qsort(entries, total, sizeof(zendump_error_entry), zendump_error_entry_compare);
+	}
+	if(limit > 0 && limit < total) {
+		php_printf("%s(%u/%u", pool ? "errors_pool" : "errors", (uint32_t)limit, total);
+	} else {
+		php_printf("%s(%u", pool ? "errors_pool" : "errors", total);
+		limit = total;
+	}
+	php_printf(") count(%" PRIu64 ") thrown(%" PRIu64 ") time(%" PRIu64 "ns)", count, thrown, time);
+	if(pool) {
+		php_printf(" requests(%" PRIu64 ")", ZENDUMP_G(error_requests));
+	}
+	PUTS(": {\n");
+	for(idx = 0; idx < limit; ++idx) {
+		site = entries[idx].site;
+		php_printf("%*c%s count(%" PRIu64 ") thrown(%" PRIu64 ") suppressed(%" PRIu64 ") time(%" PRIu64 "ns)\n", INDENT_SIZE, ' ',
+			ZSTR_VAL(entries[idx].name), site->count, site->thrown, site->suppressed, site->time);
+	}
+	PUTS("}\n");
+	if(entries) {
+		efree(entries);
+	}
+}
+
+void zendump_error_trace_reset()
+{
+	if(ZENDUMP_G(error_sites)) {
+		zend_hash_destroy(ZENDUMP_G(error_sites));
+		FREE_HASHTABLE(ZENDUMP_G(error_sites));
+		ZENDUMP_G(error_sites) = NULL;
+	}
+	if(ZENDUMP_G(error_recording)) {
+		ZENDUMP_G(error_recording) = 0;
+		++ZENDUMP_G(error_requests);
+	}
+}
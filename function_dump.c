@@ -26,6 +26,11 @@
 #include "php_ini.h"
 #include "ext/standard/info.h"
 #include "php_zendump.h"
+#include "zend_smart_str.h"
+
+#define HITS_COLUMN_WIDTH 12
+
+ZEND_EXTERN_MODULE_GLOBALS(zendump)
 
 void zendump_operand_value(zval *val, int column_width);
 void zendump_znode_op_dump(znode_op *op, zend_uchar type, uint32_t flags, zend_op *opcode, zend_op_array *op_array, int column_width);
@@ -54,6 +59,7 @@ void zendump_zend_op_array_dump(zend_op_array *op_array, int column_width)
 {
 	int idx;
 	const char *columns[] = {"OPCODE", "OP1", "OP2", "RESULT", "EXTENDED"};
+	zendump_op_array_profile *profile = ZENDUMP_G(enable_opcode_profile) ? zendump_profile_find(op_array, 0) : NULL;
 
 	if(op_array->refcount) {
 		php_printf(" refcount(%u)", *op_array->refcount);
@@ -63,30 +69,34 @@ void zendump_zend_op_array_dump(zend_op_array *op_array, int column_width)
 		php_printf(" filename(%s) line(%u,%u)\n", ZSTR_VAL(op_array->filename), op_array->line_start, op_array->line_end);
 	}
 
+	if(profile) {
+		php_printf("%-*s", HITS_COLUMN_WIDTH, "HITS");
+	}
 	for(idx = 0; idx < ARRAY_LENGTH(columns); ++idx) {
 		php_printf("%-*s", column_width, columns[idx]);
 	}
 	PUTS("\n");
 
 	for(idx = 0; idx < op_array->last; ++idx) {
+		if(profile) {
+			php_printf("%-*" PRIu64, HITS_COLUMN_WIDTH, profile->hits[idx]);
+		}
 		zendump_zend_op_dump(op_array->opcodes + idx, op_array, column_width);
 	}
 }
 
-void zendump_zend_function_proto_dump(zend_function *function, int level)
+void zendump_zend_function_proto_append(smart_str *buf, zend_function *function)
 {
 	uint32_t idx;
 	uint32_t count = function->common.num_args;
-	if(!function->common.function_name) {
-		return;
-	}
 	if(function->common.fn_flags & ZEND_ACC_VARIADIC) {
 		++count;
 	}
-	if(level > 0) {
-		php_printf("%*c", level, ' ');
+	if(function->common.fn_flags & ZEND_ACC_RETURN_REFERENCE) {
+		smart_str_appendc(buf, '&');
 	}
-	php_printf("%s%s(", (function->common.fn_flags & ZEND_ACC_RETURN_REFERENCE) ? "&" : "", ZSTR_VAL(function->common.function_name));
+	smart_str_append(buf, function->common.function_name);
+	smart_str_appendc(buf, '(');
 	for(idx = 0; idx < count; ++idx) {
 		zend_arg_info *info = function->common.arg_info + idx;
 		if(info->name) {
@@ -112,10 +122,39 @@ void zendump_zend_function_proto_dump(zend_function *function, int level)
 				}
 #endif
 			}
-			php_printf("%s%s%s%s%s$%s", idx ? ", " : "", info->is_variadic ? "..." : "", type ? type : "", type ? " " : "", info->pass_by_reference ? "&" : "", (ZEND_USER_CODE(function->type) ? ZSTR_VAL(info->name) : (const char*)info->name));
+			if(idx) {
+				smart_str_appends(buf, ", ");
+			}
+			if(info->is_variadic) {
+				smart_str_appends(buf, "...");
+			}
+			if(type) {
+				smart_str_appends(buf, type);
+				smart_str_appendc(buf, ' ');
+			}
+			if(info->pass_by_reference) {
+				smart_str_appendc(buf, '&');
+			}
+			smart_str_appendc(buf, '$');
+			smart_str_appends(buf, ZEND_USER_CODE(function->type) ? ZSTR_VAL(info->name) : (const char*)info->name);
 		}
 	}
-	PUTS(")");
+	smart_str_appendc(buf, ')');
+}
+
+void zendump_zend_function_proto_dump(zend_function *function, int level)
+{
+	smart_str buf = {0};
+	if(!function->common.function_name) {
+		return;
+	}
+	if(level > 0) {
+		php_printf("%*c", level, ' ');
+	}
+	zendump_zend_function_proto_append(&buf, function);
+	smart_str_0(&buf);
+	PHPWRITE(ZSTR_VAL(buf.s), ZSTR_LEN(buf.s));
+	smart_str_free(&buf);
 }
 
 #define DUMP_EVAL_KEYWORD_BY_ENTENDED_VALUE(extended_value, column_width) do{\
@@ -397,3 +436,176 @@ void zendump_operand_value(zval *val, int column_width)
 			break;
 	}
 }
+
+#define CODEBASE_OPCODES       0
+#define CODEBASE_VARS          1
+#define CODEBASE_TMPS          2
+#define CODEBASE_LITERALS      3
+#define CODEBASE_LITERAL_BYTES 4
+#define CODEBASE_STATICS       5
+#define CODEBASE_METRICS       6
+
+typedef struct _zendump_codebase_entry {
+	zend_op_array *op_array;
+	uint64_t      metrics[CODEBASE_METRICS];
+} zendump_codebase_entry;
+
+static size_t zendump_literal_bytes(zval *val)
+{
+	size_t size = 0;
+	zval *elem;
+
+	if(Z_TYPE_P(val) == IS_STRING) {
+		size = ZEND_MM_ALIGNED_SIZE(_ZSTR_STRUCT_SIZE(Z_STRLEN_P(val)));
+	} else if(Z_TYPE_P(val) == IS_ARRAY) {
+		size = sizeof(zend_array);
+		if(Z_ARRVAL_P(val)->u.flags & HASH_FLAG_INITIALIZED) {
+			size += HT_USED_SIZE(Z_ARRVAL_P(val));
+		}
+		ZEND_HASH_FOREACH_VAL(Z_ARRVAL_P(val), elem) {
+			size += zendump_literal_bytes(elem);
+		} ZEND_HASH_FOREACH_END();
+	}
+	return size;
+}
+
+static void zendump_codebase_collect(zendump_codebase_entry *entry, zend_op_array *op_array, uint64_t *opcode_counts)
+{
+	uint32_t idx;
+
+	entry->op_array = op_array;
+	entry->metrics[CODEBASE_OPCODES] = op_array->last;
+	entry->metrics[CODEBASE_VARS] = op_array->last_var;
+	entry->metrics[CODEBASE_TMPS] = op_array->T;
+	entry->metrics[CODEBASE_LITERALS] = op_array->last_literal;
+	entry->metrics[CODEBASE_LITERAL_BYTES] = 0;
+	for(idx = 0; idx < (uint32_t)op_array->last_literal; ++idx) {
+		entry->metrics[CODEBASE_LITERAL_BYTES] += sizeof(zval) + zendump_literal_bytes(op_array->literals + idx);
+	}
+	entry->metrics[CODEBASE_STATICS] = op_array->static_variables ? zend_hash_num_elements(op_array->static_variables) : 0;
+	for(idx = 0; idx < op_array->last; ++idx) {
+		++opcode_counts[op_array->opcodes[idx].opcode];
+	}
+}
+
+#define CODEBASE_COMPARE(metric) \
+static int zendump_codebase_compare_##metric(const void *a, const void *b) \
+{ \
+	uint64_t x = ((const zendump_codebase_entry*)a)->metrics[metric]; \
+	uint64_t y = ((const zendump_codebase_entry*)b)->metrics[metric]; \
+	return x == y ? 0 : (x < y ? 1 : -1); \
+}
+
+CODEBASE_COMPARE(CODEBASE_OPCODES)
+CODEBASE_COMPARE(CODEBASE_VARS)
+CODEBASE_COMPARE(CODEBASE_TMPS)
+CODEBASE_COMPARE(CODEBASE_LITERALS)
+CODEBASE_COMPARE(CODEBASE_LITERAL_BYTES)
+CODEBASE_COMPARE(CODEBASE_STATICS)
+
+typedef struct _zendump_codebase_opcode {
+	zend_uchar opcode;
+	uint64_t   count;
+} zendump_codebase_opcode;
+
+static int zendump_codebase_opcode_compare(const void *a, const void *b)
+{
+	const zendump_codebase_opcode *x = (const zendump_codebase_opcode*)a;
+	const zendump_codebase_opcode *y = (const zendump_codebase_opcode*)b;
+	if(x->count != y->count) {
+		return x->count < y->count ? 1 : -1;
+	}
+	return (int)x->opcode - (int)y->opcode;
+}
+
+void zendump_codebase_stats(zend_long limit, int column_width)
+{
+	const char *names[CODEBASE_METRICS] = {"opcodes", "vars", "T", "literals", "literal_bytes", "static_vars"};
+	int (*compares[CODEBASE_METRICS])(const void*, const void*) = {
+		zendump_codebase_compare_CODEBASE_OPCODES,
+		zendump_codebase_compare_CODEBASE_VARS,
+		zendump_codebase_compare_CODEBASE_TMPS,
+		zendump_codebase_compare_CODEBASE_LITERALS,
+		zendump_codebase_compare_CODEBASE_LITERAL_BYTES,
+		zendump_codebase_compare_CODEBASE_STATICS
+	};
+	uint64_t totals[CODEBASE_METRICS] = {0}, opcode_counts[256] = {0};
+	zendump_codebase_opcode opcodes[256];
+	zendump_codebase_entry *entries;
+	zend_class_entry *ce;
+	zend_function *func;
+	uint32_t count = 0, classes = 0, idx, metric, shown;
+
+	ZEND_HASH_FOREACH_PTR(EG(function_table), func) {
+		if(func->type == ZEND_USER_FUNCTION) {
+			++count;
+		}
+	} ZEND_HASH_FOREACH_END();
+	ZEND_HASH_FOREACH_PTR(EG(class_table), ce) {
+		if(ce->type != ZEND_USER_CLASS) {
+			continue;
+		}
+		++classes;
+		ZEND_HASH_FOREACH_PTR(&ce->function_table, func) {
+			if(func->type == ZEND_USER_FUNCTION && func->common.scope == ce) {
+				++count;
+			}
+		} ZEND_HASH_FOREACH_END();
+	} ZEND_HASH_FOREACH_END();
+
+	entries = safe_emalloc(count ? count : 1, sizeof(zendump_codebase_entry), 0);
+	idx = 0;
+	ZEND_HASH_FOREACH_PTR(EG(function_table), func) {
+		if(func->type == ZEND_USER_FUNCTION) {
+			zendump_codebase_collect(entries + idx++, &func->op_array, opcode_counts);
+		}
+	} ZEND_HASH_FOREACH_END();
+	ZEND_HASH_FOREACH_PTR(EG(class_table), ce) {
+		if(ce->type != ZEND_USER_CLASS) {
+			continue;
+		}
+		ZEND_HASH_FOREACH_PTR(&ce->function_table, func) {
+			if(func->type == ZEND_USER_FUNCTION && func->common.scope == ce) {
+				zendump_codebase_collect(entries + idx++, &func->op_array, opcode_counts);
+			}
+		} ZEND_HASH_FOREACH_END();
+	} ZEND_HASH_FOREACH_END();
+	for(idx = 0; idx < count; ++idx) {
+		for(metric = 0; metric < CODEBASE_METRICS; ++metric) {
+			totals[metric] += entries[idx].metrics[metric];
+		}
+	}
+
+	shown = (limit > 0 && limit < count) ? (uint32_t)limit : count;
+	php_printf("codebase functions(%u) classes(%u): {\n", count, classes);
+	for(metric = 0; metric < CODEBASE_METRICS; ++metric) {
+		php_printf("%*c%s(%" PRIu64 "): {\n", INDENT_SIZE, ' ', names[metric], totals[metric]);
+		qsort(entries, count, sizeof(zendump_codebase_entry), compares[metric]);
+		for(idx = 0; idx < shown && entries[idx].metrics[metric]; ++idx) {
+			zend_op_array *op_array = entries[idx].op_array;
+			php_printf("%*c%-*" PRIu64 "%s%s%s() %s:%u\n", INDENT_SIZE * 2, ' ', HITS_COLUMN_WIDTH, entries[idx].metrics[metric],
+				op_array->scope ? ZSTR_VAL(op_array->scope->name) : "",
+				op_array->scope ? "::" : "",
+				ZSTR_VAL(op_array->function_name),
+				op_array->filename ? ZSTR_VAL(op_array->filename) : "-",
+				op_array->line_start);
+		}
+		php_printf("%*c}\n", INDENT_SIZE, ' ');
+	}
+	shown = 0;
+	for(idx = 0; idx < ARRAY_LENGTH(opcode_counts); ++idx) {
+		if(opcode_counts[idx]) {
+			opcodes[shown].opcode = (zend_uchar)idx;
+			opcodes[shown].count = opcode_counts[idx];
+			++shown;
+		}
+	}
+	qsort(opcodes, shown, sizeof(zendump_codebase_opcode), zendump_codebase_opcode_compare);
+	php_printf("%*copcode_mix(%u): {\n", INDENT_SIZE, ' ', shown);
+	for(idx = 0; idx < shown; ++idx) {
+		php_printf("%*c%-*s%-*" PRIu64 "%.2f%%\n", INDENT_SIZE * 2, ' ', column_width, zend_get_opcode_name(opcodes[idx].opcode), HITS_COLUMN_WIDTH, opcodes[idx].count, opcodes[idx].count * 100.0 / totals[CODEBASE_OPCODES]);
+	}
+	php_printf("%*c}\n", INDENT_SIZE, ' ');
+	PUTS("}\n");
+	efree(entries);
+}
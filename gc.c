@@ -0,0 +1,246 @@
+/*
+  +----------------------------------------------------------------------+
+  | PHP Version 7                                                        |
+  +----------------------------------------------------------------------+
+  | Copyright (c) 1997-2018 The PHP Group                                |
+  +----------------------------------------------------------------------+
+  | This source file is subject to version 3.01 of the PHP license,      |
+  | that is bundled with this package in the file LICENSE, and is        |
+  | available through the world-wide-web at the following url:           |
+  | http://www.php.net/license/3_01.txt                                  |
+  | If you did not receive a copy of the PHP license and are unable to   |
+  | obtain it through the world-wide-web, please send a note to          |
+  | license@php.net so we can mail you a copy immediately.               |
+  +----------------------------------------------------------------------+
+  | Author: Youlin Feng <fengyoulin@php7th.com>                          |
+  +----------------------------------------------------------------------+
+*/
+
+/* $Id$ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "php.h"
+#include "php_ini.h"
+#include "ext/standard/info.h"
+#include "php_zendump.h"
+
+ZEND_EXTERN_MODULE_GLOBALS(zendump)
+
+typedef struct _zendump_gc_run {
+	zend_string *trigger;
+	uint32_t    roots;
+	uint32_t    collected;
+	uint64_t    time;
+} zendump_gc_run;
+
+static zend_string *zendump_gc_trigger()
+{
+	zend_execute_data *ex = EG(current_execute_data);
+	zend_function *func;
+
+	while(ex && !ex->func) {
+		ex = ex->prev_execute_data;
+	}
+	if(!ex) {
+		return zend_string_init("{shutdown}", sizeof("{shutdown}") - 1, 0);
+	}
+	func = ex->func;
+	return strpprintf(0, "%s%s%s",
+		func->common.scope ? ZSTR_VAL(func->common.scope->name) : "",
+		func->common.scope ? "::" : "",
+		func->common.function_name ? ZSTR_VAL(func->common.function_name) : "{main}");
+}
+
+static uint32_t zendump_gc_roots()
+{
+	gc_root_buffer *root;
+	uint32_t count = 0;
+
+	for(root = GC_G(roots).next; root != &GC_G(roots); root = root->next) {
+		++count;
+	}
+	return count;
+}
+
+static void zendump_gc_garbage_record(zend_class_entry *ce)
+{
+	zval *count, zero;
+
+	if(!ZENDUMP_G(gc_garbage)) {
+		ALLOC_HASHTABLE(ZENDUMP_G(gc_garbage));
+		zend_hash_init(ZENDUMP_G(gc_garbage), 16, NULL, NULL, 0);
+	}
+	count = zend_hash_find(ZENDUMP_G(gc_garbage), ce->name);
+	if(!count) {
+		ZVAL_LONG(&zero, 0);
+		count = zend_hash_add_new(ZENDUMP_G(gc_garbage), ce->name, &zero);
+	}
+	++Z_LVAL_P(count);
+}
+
+/* The collector frees the garbage objects through the objects store, so the
+   classes of the live objects are snapshotted before the run and every slot
+   that is no longer valid afterwards held garbage. The snapshot is taken
+   outside of the timed region and only costs a pointer per object. */
+static int zendump_gc_collect_cycles(void)
+{
+	zend_class_entry **classes = NULL;
+	zendump_gc_run *run;
+	uint32_t idx, top = 0, roots;
+	uint64_t start, elapsed;
+	int collected;
+
+	if(!ZENDUMP_G(gc_recording) || GC_G(gc_active)) {
+		return ZENDUMP_G(origin_gc_collect_cycles)();
+	}
+
+	roots = zendump_gc_roots();
+	if(EG(objects_store).object_buckets) {
+		top = EG(objects_store).top;
+		classes = safe_emalloc(top, sizeof(zend_class_entry*), 0);
+		for(idx = 1; idx < top; ++idx) {
+			zend_object *obj = EG(objects_store).object_buckets[idx];
+			classes[idx] = IS_OBJ_VALID(obj) ? obj->ce : NULL;
+		}
+	}
+
+	start = zendump_time_ns();
+	collected = ZENDUMP_G(origin_gc_collect_cycles)();
+	elapsed = zendump_time_ns() - start;
+
+	if(classes) {
+		for(idx = 1; idx < top; ++idx) {
+			zend_object *obj;
+			if(!classes[idx]) {
+				continue;
+			}
+			obj = idx < EG(objects_store).top ? EG(objects_store).object_buckets[idx] : NULL;
+			if(!IS_OBJ_VALID(obj) || obj->ce != classes[idx]) {
+				zendump_gc_garbage_record(classes[idx]);
+			}
+		}
+		efree(classes);
+	}
+
+	if(ZENDUMP_G(gc_runs_count) == ZENDUMP_G(gc_runs_size)) {
+		ZENDUMP_G(gc_runs_size) = ZENDUMP_G(gc_runs_size) ? ZENDUMP_G(gc_runs_size) * 2 : 8;
+		ZENDUMP_G(gc_runs) = safe_erealloc(ZENDUMP_G(gc_runs), ZENDUMP_G(gc_runs_size), sizeof(zendump_gc_run), 0);
+	}
+	run = ZENDUMP_G(gc_runs) + ZENDUMP_G(gc_runs_count)++;
+	run->trigger = zendump_gc_trigger();
+	run->roots = roots;
+	run->collected = collected;
+	run->time = elapsed;
+	return collected;
+}
+
+void zendump_gc_profile_startup()
+{
+	ZENDUMP_G(origin_gc_collect_cycles) = gc_collect_cycles;
+	gc_collect_cycles = zendump_gc_collect_cycles;
+}
+
+void zendump_gc_profile_shutdown()
+{
+	if(gc_collect_cycles == zendump_gc_collect_cycles) {
+		gc_collect_cycles = ZENDUMP_G(origin_gc_collect_cycles);
+	}
+}
+
+static int zendump_gc_run_compare(const void *a, const void *b)
+{
+	const zendump_gc_run *x = (const zendump_gc_run*)a;
+	const zendump_gc_run *y = (const zendump_gc_run*)b;
+	if(x->time != y->time) {
+		return x->time < y->time ? 1 : -1;
+	}
+	return 0;
+}
+
+static int zendump_gc_garbage_compare(const void *a, const void *b)
+{
+	zend_long x = Z_LVAL(((Bucket*)a)->val);
+	zend_long y = Z_LVAL(((Bucket*)b)->val);
+	if(x != y) {
+		return x < y ? 1 : -1;
+	}
+	return zend_binary_strcmp(ZSTR_VAL(((Bucket*)a)->key), ZSTR_LEN(((Bucket*)a)->key), ZSTR_VAL(((Bucket*)b)->key), ZSTR_LEN(((Bucket*)b)->key));
+}
+
+void zendump_gc_profile_dump(zend_long limit)
+{
+	zendump_gc_run *runs = ZENDUMP_G(gc_runs);
+	uint32_t count = ZENDUMP_G(gc_runs_count), idx;
+	uint64_t time = 0, collected = 0, max = 0;
+	zend_long shown = limit, total;
+	zend_string *name;
+	zval *hits;
+
+	for(idx = 0; idx < count; ++idx) {
+		time += runs[idx].time;
+		collected += runs[idx].collected;
+		if(runs[idx].time > max) {
+			max = runs[idx].time;
+		}
+	}
+	if(count) {
+		qsort(runs, count, sizeof(zendump_gc_run), zendump_gc_run_compare);
+	}
+	if(shown > 0 && shown < count) {
+		php_printf("gc(%u/%u", (uint32_t)shown, count);
+	} else {
+		php_printf("gc(%u", count);
+		shown = count;
+	}
+	php_printf(") time(%" PRIu64 "ns) max(%" PRIu64 "ns) collected(%" PRIu64 "): {\n", time, max, collected);
+	for(idx = 0; idx < shown; ++idx) {
+		php_printf("%*c%s roots(%u) collected(%u) time(%" PRIu64 "ns)\n", INDENT_SIZE, ' ',
+			ZSTR_VAL(runs[idx].trigger), runs[idx].roots, runs[idx].collected, runs[idx].time);
+	}
+	PUTS("}\n");
+
+	total = ZENDUMP_G(gc_garbage) ? zend_hash_num_elements(ZENDUMP_G(gc_garbage)) : 0;
+	if(total) {
+		zend_hash_sort(ZENDUMP_G(gc_garbage), zendump_gc_garbage_compare, 0);
+	}
+	if(limit > 0 && limit < total) {
+		php_printf("garbage(" ZEND_LONG_FMT "/" ZEND_LONG_FMT "): {\n", limit, total);
+	} else {
+		php_printf("garbage(" ZEND_LONG_FMT "): {\n", total);
+		limit = total;
+	}
+	shown = 0;
+	if(limit) {
+		ZEND_HASH_FOREACH_STR_KEY_VAL(ZENDUMP_G(gc_garbage), name, hits) {
+			if(shown++ == limit) {
+				break;
+			}
+			php_printf("%*c%s count(" ZEND_LONG_FMT ")\n", INDENT_SIZE, ' ', ZSTR_VAL(name), Z_LVAL_P(hits));
+		} ZEND_HASH_FOREACH_END();
+	}
+	PUTS("}\n");
+}
+
+void zendump_gc_profile_reset()
+{
+	uint32_t idx;
+
+	for(idx = 0; idx < ZENDUMP_G(gc_runs_count); ++idx) {
+		zend_string_release(ZENDUMP_G(gc_runs)[idx].trigger);
+	}
+	if(ZENDUMP_G(gc_runs)) {
+		efree(ZENDUMP_G(gc_runs));
+		ZENDUMP_G(gc_runs) = NULL;
+	}
+	ZENDUMP_G(gc_runs_count) = 0;
+	ZENDUMP_G(gc_runs_size) = 0;
+	if(ZENDUMP_G(gc_garbage)) {
+		zend_hash_destroy(ZENDUMP_G(gc_garbage));
+		FREE_HASHTABLE(ZENDUMP_G(gc_garbage));
+		ZENDUMP_G(gc_garbage) = NULL;
+	}
+	ZENDUMP_G(gc_recording) = 0;
+}
@@ -0,0 +1,888 @@
+/*
+  +----------------------------------------------------------------------+
+  | PHP Version 7                                                        |
+  +----------------------------------------------------------------------+
+  | Copyright (c) 1997-2018 The PHP Group                                |
+  +----------------------------------------------------------------------+
+  | This source file is subject to version 3.01 of the PHP license,      |
+  | that is bundled with this package in the file LICENSE, and is        |
+  | available through the world-wide-web at the following url:           |
+  | http://www.php.net/license/3_01.txt                                  |
+  | If you did not receive a copy of the PHP license and are unable to   |
+  | obtain it through the world-wide-web, please send a note to          |
+  | license@php.net so we can mail you a copy immediately.               |
+  +----------------------------------------------------------------------+
+  | Author: Youlin Feng <fengyoulin@php7th.com>                          |
+  +----------------------------------------------------------------------+
+*/
+
+/* $Id$ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "php.h"
+#include "php_ini.h"
+#include "ext/standard/info.h"
+#include "php_zendump.h"
+#include "zend_objects_API.h"
+#include "zend_smart_str.h"
+
+ZEND_EXTERN_MODULE_GLOBALS(zendump)
+
+typedef struct _zendump_cow_site {
+	zend_string *filename;
+	uint32_t    lineno;
+	uint64_t    count;
+	uint64_t    elements;
+	uint64_t    bytes;
+} zendump_cow_site;
+
+static void zendump_cow_site_dtor(zval *zv)
+{
+	zendump_cow_site *site = (zendump_cow_site*)Z_PTR_P(zv);
+	zend_string_release(site->filename);
+	efree(site);
+}
+
+static void zendump_cow_lines_dtor(zval *zv)
+{
+	zend_hash_destroy((HashTable*)Z_PTR_P(zv));
+	FREE_HASHTABLE(Z_PTR_P(zv));
+}
+
+static void zendump_cow_record(zend_execute_data *execute_data, const zend_op *opline, zend_array *arr)
+{
+	zend_string *filename = EX(func)->op_array.filename;
+	HashTable *lines;
+	zendump_cow_site *site;
+
+	if(!ZENDUMP_G(cow_sites)) {
+		ALLOC_HASHTABLE(ZENDUMP_G(cow_sites));
+		zend_hash_init(ZENDUMP_G(cow_sites), 8, NULL, zendump_cow_lines_dtor, 0);
+	}
+	lines = zend_hash_find_ptr(ZENDUMP_G(cow_sites), filename);
+	if(!lines) {
+		ALLOC_HASHTABLE(lines);
+		zend_hash_init(lines, 8, NULL, zendump_cow_site_dtor, 0);
+		zend_hash_add_new_ptr(ZENDUMP_G(cow_sites), filename, lines);
+	}
+	site = zend_hash_index_find_ptr(lines, opline->lineno);
+	if(!site) {
+		site = ecalloc(1, sizeof(zendump_cow_site));
+		site->filename = zend_string_copy(filename);
+		site->lineno = opline->lineno;
+		zend_hash_index_add_new_ptr(lines, opline->lineno, site);
+	}
+	++site->count;
+	site->elements += arr->nNumOfElements;
+	site->bytes += sizeof(zend_array);
+	if(arr->u.flags & HASH_FLAG_INITIALIZED) {
+		site->bytes += HT_USED_SIZE(arr);
+	}
+}
+
+/* Called before the handler of a write opcode, so an array still shared by more
+   than one holder at this point is about to be duplicated by SEPARATE_ARRAY(). */
+void zendump_cow_observe(zend_execute_data *execute_data, const zend_op *opline)
+{
+	zval *container;
+
+	switch(opline->opcode) {
+		case ZEND_ASSIGN_ADD:
+		case ZEND_ASSIGN_SUB:
+		case ZEND_ASSIGN_MUL:
+		case ZEND_ASSIGN_DIV:
+		case ZEND_ASSIGN_MOD:
+		case ZEND_ASSIGN_SL:
+		case ZEND_ASSIGN_SR:
+		case ZEND_ASSIGN_CONCAT:
+		case ZEND_ASSIGN_BW_OR:
+		case ZEND_ASSIGN_BW_AND:
+		case ZEND_ASSIGN_BW_XOR:
+		case ZEND_ASSIGN_POW:
+			if(opline->extended_value != ZEND_ASSIGN_DIM) {
+				return;
+			}
+			break;
+	}
+
+	container = zendump_operand_zval(execute_data, opline->op1_type, &opline->op1);
+	if(!container) {
+		return;
+	}
+	ZVAL_DEREF(container);
+	if(Z_TYPE_P(container) == IS_ARRAY && GC_REFCOUNT(Z_ARRVAL_P(container)) > 1) {
+		zendump_cow_record(execute_data, opline, Z_ARRVAL_P(container));
+	}
+}
+
+void zendump_cow_startup()
+{
+	const zend_uchar opcodes[] = {
+		ZEND_ASSIGN_DIM, ZEND_FETCH_DIM_W, ZEND_FETCH_DIM_RW, ZEND_UNSET_DIM, ZEND_FE_RESET_RW,
+		ZEND_ASSIGN_ADD, ZEND_ASSIGN_SUB, ZEND_ASSIGN_MUL, ZEND_ASSIGN_DIV, ZEND_ASSIGN_MOD, ZEND_ASSIGN_SL, ZEND_ASSIGN_SR,
+		ZEND_ASSIGN_CONCAT, ZEND_ASSIGN_BW_OR, ZEND_ASSIGN_BW_AND, ZEND_ASSIGN_BW_XOR, ZEND_ASSIGN_POW
+	};
+	int idx;
+	for(idx = 0; idx < ARRAY_LENGTH(opcodes); ++idx) {
+		zendump_observe_opcode(opcodes[idx], zendump_cow_observe);
+	}
+}
+
+static int zendump_cow_site_compare(const void *a, const void *b)
+{
+	const zendump_cow_site *x = *(const zendump_cow_site**)a;
+	const zendump_cow_site *y = *(const zendump_cow_site**)b;
+	if(x->bytes != y->bytes) {
+		return x->bytes < y->bytes ? 1 : -1;
+	}
+	return x->count < y->count ? 1 : (x->count > y->count ? -1 : 0);
+}
+
+void zendump_cow_report(zend_long limit)
+{
+	zendump_cow_site **sites;
+	HashTable *lines;
+	zendump_cow_site *site;
+	uint32_t count = 0, idx;
+
+	if(ZENDUMP_G(cow_sites)) {
+		ZEND_HASH_FOREACH_PTR(ZENDUMP_G(cow_sites), lines) {
+			count += zend_hash_num_elements(lines);
+		} ZEND_HASH_FOREACH_END();
+	}
+	if(limit > 0 && limit < count) {
+		php_printf("cow(%u/%u): {\n", (uint32_t)limit, count);
+	} else {
+		php_printf("cow(%u): {\n", count);
+		limit = count;
+	}
+	if(count) {
+		sites = safe_emalloc(count, sizeof(zendump_cow_site*), 0);
+		idx = 0;
+		ZEND_HASH_FOREACH_PTR(ZENDUMP_G(cow_sites), lines) {
+			ZEND_HASH_FOREACH_PTR(lines, site) {
+				sites[idx++] = site;
+			} ZEND_HASH_FOREACH_END();
+		} ZEND_HASH_FOREACH_END();
+		qsort(sites, count, sizeof(zendump_cow_site*), zendump_cow_site_compare);
+		for(idx = 0; idx < limit; ++idx) {
+			site = sites[idx];
+			php_printf("%*c%s:%u count(%" PRIu64 ") elements(%" PRIu64 ") bytes(%" PRIu64 ")\n", INDENT_SIZE, ' ', ZSTR_VAL(site->filename), site->lineno, site->count, site->elements, site->bytes);
+		}
+		efree(sites);
+	}
+	PUTS("}\n");
+}
+
+void zendump_cow_reset()
+{
+	if(ZENDUMP_G(cow_sites)) {
+		zend_hash_destroy(ZENDUMP_G(cow_sites));
+		FREE_HASHTABLE(ZENDUMP_G(cow_sites));
+		ZENDUMP_G(cow_sites) = NULL;
+	}
+}
+
+typedef struct _zendump_properties_site {
+	zend_class_entry *ce;
+	zend_string      *filename;
+	uint32_t         lineno;
+	zend_uchar       opcode;
+	uint64_t         count;
+} zendump_properties_site;
+
+typedef struct _zendump_class_survey {
+	zend_class_entry *ce;
+	uint32_t         instances;
+	uint32_t         materialized;
+	size_t           bytes;
+} zendump_class_survey;
+
+static void zendump_properties_site_dtor(zval *zv)
+{
+	zendump_properties_site *site = (zendump_properties_site*)Z_PTR_P(zv);
+	zend_string_release(site->filename);
+	efree(site);
+}
+
+static size_t zendump_properties_size(zend_object *obj)
+{
+	size_t size = sizeof(zend_array);
+	if(obj->properties->u.flags & HASH_FLAG_INITIALIZED) {
+		size += HT_USED_SIZE(obj->properties);
+	}
+	return size;
+}
+
+static void zendump_properties_pending_add(zend_execute_data *execute_data, const zend_op *opline, zval *val)
+{
+	zendump_pending_object *pending;
+
+	if(!val) {
+		return;
+	}
+	ZVAL_DEREF(val);
+	if(Z_TYPE_P(val) != IS_OBJECT || Z_OBJ_P(val)->properties || ZENDUMP_G(properties_pending_count) == ARRAY_LENGTH(ZENDUMP_G(properties_pending))) {
+		return;
+	}
+	pending = &ZENDUMP_G(properties_pending)[ZENDUMP_G(properties_pending_count)++];
+	pending->obj = Z_OBJ_P(val);
+	pending->handle = Z_OBJ_HANDLE_P(val);
+	pending->opcode = opline->opcode;
+	pending->lineno = opline->lineno;
+	pending->filename = zend_string_copy(EX(func)->op_array.filename);
+}
+
+static void zendump_properties_resolve()
+{
+	uint32_t idx;
+	zend_string *key;
+	zendump_properties_site *site;
+
+	for(idx = 0; idx < ZENDUMP_G(properties_pending_count); ++idx) {
+		zendump_pending_object *pending = &ZENDUMP_G(properties_pending)[idx];
+		if(pending->handle < EG(objects_store).top && EG(objects_store).object_buckets[pending->handle] == pending->obj && pending->obj->properties) {
+			if(!ZENDUMP_G(properties_sites)) {
+				ALLOC_HASHTABLE(ZENDUMP_G(properties_sites));
+				zend_hash_init(ZENDUMP_G(properties_sites), 8, NULL, zendump_properties_site_dtor, 0);
+			}
+			key = strpprintf(0, "%s@%s:%u#%u", ZSTR_VAL(pending->obj->ce->name), ZSTR_VAL(pending->filename), pending->lineno, pending->opcode);
+			site = zend_hash_find_ptr(ZENDUMP_G(properties_sites), key);
+			if(!site) {
+				site = ecalloc(1, sizeof(zendump_properties_site));
+				site->ce = pending->obj->ce;
+				site->filename = zend_string_copy(pending->filename);
+				site->lineno = pending->lineno;
+				site->opcode = pending->opcode;
+				zend_hash_add_new_ptr(ZENDUMP_G(properties_sites), key, site);
+			}
+			++site->count;
+			zend_string_release(key);
+		}
+		zend_string_release(pending->filename);
+	}
+	ZENDUMP_G(properties_pending_count) = 0;
+}
+
+/* Objects seen without a properties table are checked again before the next
+   opcode runs, which attributes the materialization to the opcode in between. */
+void zendump_properties_observe(zend_execute_data *execute_data, const zend_op *opline)
+{
+	if(ZENDUMP_G(properties_pending_count)) {
+		zendump_properties_resolve();
+	}
+
+	switch(opline->opcode) {
+		case ZEND_ASSIGN_ADD:
+		case ZEND_ASSIGN_SUB:
+		case ZEND_ASSIGN_MUL:
+		case ZEND_ASSIGN_DIV:
+		case ZEND_ASSIGN_MOD:
+		case ZEND_ASSIGN_SL:
+		case ZEND_ASSIGN_SR:
+		case ZEND_ASSIGN_CONCAT:
+		case ZEND_ASSIGN_BW_OR:
+		case ZEND_ASSIGN_BW_AND:
+		case ZEND_ASSIGN_BW_XOR:
+		case ZEND_ASSIGN_POW:
+			if(opline->extended_value != ZEND_ASSIGN_OBJ) {
+				break;
+			}
+			/* break missing intentionally */
+		case ZEND_ASSIGN_OBJ:
+		case ZEND_FETCH_OBJ_W:
+		case ZEND_FETCH_OBJ_RW:
+		case ZEND_FETCH_OBJ_FUNC_ARG:
+		case ZEND_FETCH_OBJ_UNSET:
+		case ZEND_UNSET_OBJ:
+		case ZEND_PRE_INC_OBJ:
+		case ZEND_PRE_DEC_OBJ:
+		case ZEND_POST_INC_OBJ:
+		case ZEND_POST_DEC_OBJ:
+			if(opline->op1_type == IS_UNUSED) {
+				if(Z_TYPE(EX(This)) == IS_OBJECT) {
+					zendump_properties_pending_add(execute_data, opline, &EX(This));
+				}
+				break;
+			}
+			/* break missing intentionally */
+		case ZEND_FE_RESET_R:
+		case ZEND_FE_RESET_RW:
+		case ZEND_CAST:
+			zendump_properties_pending_add(execute_data, opline, zendump_operand_zval(execute_data, opline->op1_type, &opline->op1));
+			break;
+		case ZEND_DO_ICALL:
+		case ZEND_DO_UCALL:
+		case ZEND_DO_FCALL_BY_NAME:
+		case ZEND_DO_FCALL: {
+			zend_execute_data *call = EX(call);
+			uint32_t idx;
+			if(!call) {
+				break;
+			}
+			for(idx = 1; idx <= ZEND_CALL_NUM_ARGS(call) && idx <= 4; ++idx) {
+				zendump_properties_pending_add(execute_data, opline, ZEND_CALL_ARG(call, idx));
+			}
+			break;
+		}
+	}
+}
+
+static int zendump_class_survey_compare(const void *a, const void *b)
+{
+	const zendump_class_survey *x = *(const zendump_class_survey**)a;
+	const zendump_class_survey *y = *(const zendump_class_survey**)b;
+	if(x->bytes != y->bytes) {
+		return x->bytes < y->bytes ? 1 : -1;
+	}
+	if(x->instances != y->instances) {
+		return x->instances < y->instances ? 1 : -1;
+	}
+	return strcmp(ZSTR_VAL(x->ce->name), ZSTR_VAL(y->ce->name));
+}
+
+void zendump_objects_survey(zend_long limit)
+{
+	HashTable classes;
+	zendump_class_survey *survey, **surveys;
+	zendump_properties_site *site;
+	uint32_t idx, count;
+
+	if(ZENDUMP_G(properties_pending_count)) {
+		zendump_properties_resolve();
+	}
+
+	zend_hash_init(&classes, 16, NULL, NULL, 0);
+	for(idx = 1; idx < EG(objects_store).top; ++idx) {
+		zend_object *obj = EG(objects_store).object_buckets[idx];
+		if(!IS_OBJ_VALID(obj)) {
+			continue;
+		}
+		survey = zend_hash_index_find_ptr(&classes, (zend_ulong)(zend_uintptr_t)obj->ce);
+		if(!survey) {
+			survey = ecalloc(1, sizeof(zendump_class_survey));
+			survey->ce = obj->ce;
+			zend_hash_index_add_new_ptr(&classes, (zend_ulong)(zend_uintptr_t)obj->ce, survey);
+		}
+		++survey->instances;
+		if(obj->properties) {
+			++survey->materialized;
+			survey->bytes += zendump_properties_size(obj);
+		}
+	}
+
+	count = zend_hash_num_elements(&classes);
+	if(limit > 0 && limit < count) {
+		php_printf("objects(%u/%u): {\n", (uint32_t)limit, count);
+	} else {
+		php_printf("objects(%u): {\n", count);
+		limit = count;
+	}
+	if(count) {
+		surveys = safe_emalloc(count, sizeof(zendump_class_survey*), 0);
+		idx = 0;
+		ZEND_HASH_FOREACH_PTR(&classes, survey) {
+			surveys[idx++] = survey;
+		} ZEND_HASH_FOREACH_END();
+		qsort(surveys, count, sizeof(zendump_class_survey*), zendump_class_survey_compare);
+		for(idx = 0; idx < limit; ++idx) {
+			survey = surveys[idx];
+			php_printf("%*c\"%s\" instances(%u) materialized(%u) bytes(%zu)\n", INDENT_SIZE, ' ', ZSTR_VAL(survey->ce->name), survey->instances, survey->materialized, survey->bytes);
+			if(ZENDUMP_G(properties_sites)) {
+				ZEND_HASH_FOREACH_PTR(ZENDUMP_G(properties_sites), site) {
+					if(site->ce == survey->ce) {
+						php_printf("%*c%s:%u %s count(%" PRIu64 ")\n", INDENT_SIZE << 1, ' ', ZSTR_VAL(site->filename), site->lineno, zend_get_opcode_name(site->opcode), site->count);
+					}
+				} ZEND_HASH_FOREACH_END();
+			}
+		}
+		for(idx = 0; idx < count; ++idx) {
+			efree(surveys[idx]);
+		}
+		efree(surveys);
+	}
+	zend_hash_destroy(&classes);
+	PUTS("}\n");
+}
+
+void zendump_properties_reset()
+{
+	uint32_t idx;
+	for(idx = 0; idx < ZENDUMP_G(properties_pending_count); ++idx) {
+		zend_string_release(ZENDUMP_G(properties_pending)[idx].filename);
+	}
+	ZENDUMP_G(properties_pending_count) = 0;
+	if(ZENDUMP_G(properties_sites)) {
+		zend_hash_destroy(ZENDUMP_G(properties_sites));
+		FREE_HASHTABLE(ZENDUMP_G(properties_sites));
+		ZENDUMP_G(properties_sites) = NULL;
+	}
+}
+
+#define STRING_AUDIT_MAX_DEPTH 64
+#define STRING_AUDIT_PATH_COMPONENT 32
+#define STRING_AUDIT_CONTENT_PREVIEW 48
+
+typedef struct _zendump_string_dup {
+	zend_string *str;
+	uint32_t    count;
+	size_t      size;
+	zend_string *paths[2];
+} zendump_string_dup;
+
+typedef struct _zendump_string_audit {
+	HashTable strings;  /* addresses of the zend_strings already counted */
+	HashTable arrays;   /* addresses of the zend_arrays already walked */
+	HashTable contents; /* string content => zendump_string_dup */
+	smart_str path;
+} zendump_string_audit;
+
+static void zendump_string_dup_dtor(zval *zv)
+{
+	zendump_string_dup *dup = (zendump_string_dup*)Z_PTR_P(zv);
+	if(dup->paths[0]) {
+		zend_string_release(dup->paths[0]);
+	}
+	if(dup->paths[1]) {
+		zend_string_release(dup->paths[1]);
+	}
+	efree(dup);
+}
+
+static void zendump_string_audit_path_append(zendump_string_audit *audit, const char *str, size_t len)
+{
+	smart_str_appendl(&audit->path, str, len > STRING_AUDIT_PATH_COMPONENT ? STRING_AUDIT_PATH_COMPONENT : len);
+	if(len > STRING_AUDIT_PATH_COMPONENT) {
+		smart_str_appends(&audit->path, "...");
+	}
+}
+
+static size_t zendump_string_audit_path_mark(zendump_string_audit *audit)
+{
+	return audit->path.s ? ZSTR_LEN(audit->path.s) : 0;
+}
+
+static void zendump_string_audit_path_restore(zendump_string_audit *audit, size_t mark)
+{
+	if(audit->path.s) {
+		ZSTR_LEN(audit->path.s) = mark;
+	}
+}
+
+static void zendump_string_audit_string(zendump_string_audit *audit, zend_string *str)
+{
+	zendump_string_dup *dup;
+
+	if(IS_INTERNED(str) || !zend_hash_index_add_empty_element(&audit->strings, (zend_ulong)(zend_uintptr_t)str)) {
+		return;
+	}
+	dup = zend_hash_find_ptr(&audit->contents, str);
+	if(!dup) {
+		dup = ecalloc(1, sizeof(zendump_string_dup));
+		dup->str = str;
+		dup->size = ZEND_MM_ALIGNED_SIZE(_ZSTR_STRUCT_SIZE(ZSTR_LEN(str)));
+		zend_hash_add_new_ptr(&audit->contents, str, dup);
+	}
+	if(dup->count < ARRAY_LENGTH(dup->paths)) {
+		dup->paths[dup->count] = audit->path.s ? zend_string_init(ZSTR_VAL(audit->path.s), ZSTR_LEN(audit->path.s), 0) : ZSTR_EMPTY_ALLOC();
+	}
+	++dup->count;
+}
+
+static void zendump_string_audit_array(zendump_string_audit *audit, zend_array *arr, int depth);
+
+static void zendump_string_audit_zval(zendump_string_audit *audit, zval *val, int depth)
+{
+again:
+	switch(Z_TYPE_P(val)) {
+		case IS_STRING:
+			zendump_string_audit_string(audit, Z_STR_P(val));
+			break;
+		case IS_ARRAY:
+			zendump_string_audit_array(audit, Z_ARRVAL_P(val), depth + 1);
+			break;
+		case IS_REFERENCE:
+			val = Z_REFVAL_P(val);
+			goto again;
+		case IS_INDIRECT:
+			val = Z_INDIRECT_P(val);
+			goto again;
+	}
+}
+
+/* Objects met inside arrays are not followed, the objects store walk reaches
+   every live object exactly once. */
+static void zendump_string_audit_array(zendump_string_audit *audit, zend_array *arr, int depth)
+{
+	zend_ulong h;
+	zend_string *key;
+	zval *val;
+	size_t mark;
+
+	if(depth > STRING_AUDIT_MAX_DEPTH || !zend_hash_index_add_empty_element(&audit->arrays, (zend_ulong)(zend_uintptr_t)arr)) {
+		return;
+	}
+	ZEND_HASH_FOREACH_KEY_VAL(arr, h, key, val) {
+		mark = zendump_string_audit_path_mark(audit);
+		if(key) {
+			smart_str_appends(&audit->path, "[\"");
+			zendump_string_audit_path_append(audit, ZSTR_VAL(key), ZSTR_LEN(key));
+			smart_str_appends(&audit->path, "\"]");
+			zendump_string_audit_string(audit, key);
+		} else {
+			smart_str_appendc(&audit->path, '[');
+			smart_str_append_unsigned(&audit->path, h);
+			smart_str_appendc(&audit->path, ']');
+		}
+		zendump_string_audit_zval(audit, val, depth);
+		zendump_string_audit_path_restore(audit, mark);
+	} ZEND_HASH_FOREACH_END();
+}
+
+static void zendump_string_audit_root(zendump_string_audit *audit, const char *prefix, zend_string *name, const char *suffix, zval *val)
+{
+	size_t mark = zendump_string_audit_path_mark(audit);
+	smart_str_appends(&audit->path, prefix);
+	if(name) {
+		zendump_string_audit_path_append(audit, ZSTR_VAL(name), ZSTR_LEN(name));
+	}
+	smart_str_appends(&audit->path, suffix);
+	zendump_string_audit_zval(audit, val, 0);
+	zendump_string_audit_path_restore(audit, mark);
+}
+
+static void zendump_string_audit_statics(zendump_string_audit *audit, zend_function *func)
+{
+	zend_string *key;
+	zval *val;
+	size_t mark;
+
+	if(func->type != ZEND_USER_FUNCTION || !func->op_array.static_variables) {
+		return;
+	}
+	mark = zendump_string_audit_path_mark(audit);
+	if(func->common.scope) {
+		zendump_string_audit_path_append(audit, ZSTR_VAL(func->common.scope->name), ZSTR_LEN(func->common.scope->name));
+		smart_str_appends(&audit->path, "::");
+	}
+	if(func->common.function_name) {
+		zendump_string_audit_path_append(audit, ZSTR_VAL(func->common.function_name), ZSTR_LEN(func->common.function_name));
+	}
+	ZEND_HASH_FOREACH_STR_KEY_VAL(func->op_array.static_variables, key, val) {
+		if(key) {
+			zendump_string_audit_root(audit, "()::static $", key, "", val);
+		}
+	} ZEND_HASH_FOREACH_END();
+	zendump_string_audit_path_restore(audit, mark);
+}
+
+static void zendump_string_audit_object(zendump_string_audit *audit, zend_object *obj)
+{
+	zend_string *key;
+	zval *val;
+	uint32_t idx;
+	size_t mark = zendump_string_audit_path_mark(audit);
+
+	zendump_string_audit_path_append(audit, ZSTR_VAL(obj->ce->name), ZSTR_LEN(obj->ce->name));
+	smart_str_appendc(&audit->path, '#');
+	smart_str_append_unsigned(&audit->path, obj->handle);
+	if(obj->properties) {
+		ZEND_HASH_FOREACH_STR_KEY_VAL(obj->properties, key, val) {
+			if(key) {
+				zendump_string_audit_string(audit, key);
+			}
+			zendump_string_audit_root(audit, "->", key, "", val);
+		} ZEND_HASH_FOREACH_END();
+	} else if(obj->ce->default_properties_count) {
+		zendump_class_layout *layout = zendump_class_layout_get(obj->ce);
+		for(idx = 0; idx < layout->properties_count; ++idx) {
+			zendump_string_audit_root(audit, "->", layout->names[idx], "", obj->properties_table + idx);
+		}
+	}
+	zendump_string_audit_path_restore(audit, mark);
+}
+
+static int zendump_string_dup_compare(const void *a, const void *b)
+{
+	const zendump_string_dup *x = *(const zendump_string_dup**)a;
+	const zendump_string_dup *y = *(const zendump_string_dup**)b;
+	size_t wx = (x->count - 1) * x->size, wy = (y->count - 1) * y->size;
+	if(wx != wy) {
+		return wx < wy ? 1 : -1;
+	}
+	return x->count < y->count ? 1 : (x->count > y->count ? -1 : 0);
+}
+
+void zendump_string_audit(zend_long limit)
+{
+	zendump_string_audit audit;
+	zendump_string_dup *dup, **dups;
+	zend_class_entry *ce;
+	zend_function *func;
+	zend_string *key;
+	zval *val;
+	uint32_t idx, count = 0;
+	size_t wasted = 0;
+
+	zend_hash_init(&audit.strings, 256, NULL, NULL, 0);
+	zend_hash_init(&audit.arrays, 64, NULL, NULL, 0);
+	zend_hash_init(&audit.contents, 256, NULL, zendump_string_dup_dtor, 0);
+	memset(&audit.path, 0, sizeof(smart_str));
+
+	/* $GLOBALS points back to the symbol table, mark it visited so the
+	   globals are reported under their own names. */
+	zend_hash_index_add_empty_element(&audit.arrays, (zend_ulong)(zend_uintptr_t)&EG(symbol_table));
+	ZEND_HASH_FOREACH_STR_KEY_VAL(&EG(symbol_table), key, val) {
+		if(key) {
+			zendump_string_audit_root(&audit, "$", key, "", val);
+		}
+	} ZEND_HASH_FOREACH_END();
+
+	for(idx = 1; idx < EG(objects_store).top; ++idx) {
+		zend_object *obj = EG(objects_store).object_buckets[idx];
+		if(IS_OBJ_VALID(obj)) {
+			zendump_string_audit_object(&audit, obj);
+		}
+	}
+
+	ZEND_HASH_FOREACH_PTR(EG(class_table), ce) {
+		if(ce->type != ZEND_USER_CLASS) {
+			continue;
+		}
+		if(ce->static_members_table && ce->default_static_members_count) {
+			zendump_class_layout *layout = zendump_class_layout_get(ce);
+			for(idx = 0; idx < layout->static_members_count; ++idx) {
+				size_t mark = zendump_string_audit_path_mark(&audit);
+				zendump_string_audit_path_append(&audit, ZSTR_VAL(ce->name), ZSTR_LEN(ce->name));
+				zendump_string_audit_root(&audit, "::$", layout->names[layout->properties_count + idx], "", ce->static_members_table + idx);
+				zendump_string_audit_path_restore(&audit, mark);
+			}
+		}
+		ZEND_HASH_FOREACH_PTR(&ce->function_table, func) {
+			zendump_string_audit_statics(&audit, func);
+		} ZEND_HASH_FOREACH_END();
+	} ZEND_HASH_FOREACH_END();
+
+	ZEND_HASH_FOREACH_PTR(EG(function_table), func) {
+		zendump_string_audit_statics(&audit, func);
+	} ZEND_HASH_FOREACH_END();
+
+	ZEND_HASH_FOREACH_PTR(&audit.contents, dup) {
+		if(dup->count > 1) {
+			++count;
+			wasted += (dup->count - 1) * dup->size;
+		}
+	} ZEND_HASH_FOREACH_END();
+
+	if(limit > 0 && limit < count) {
+		php_printf("strings(%u/%u) wasted(%zu): {\n", (uint32_t)limit, count, wasted);
+	} else {
+		php_printf("strings(%u) wasted(%zu): {\n", count, wasted);
+		limit = count;
+	}
+	if(count) {
+		dups = safe_emalloc(count, sizeof(zendump_string_dup*), 0);
+		idx = 0;
+		ZEND_HASH_FOREACH_PTR(&audit.contents, dup) {
+			if(dup->count > 1) {
+				dups[idx++] = dup;
+			}
+		} ZEND_HASH_FOREACH_END();
+		qsort(dups, count, sizeof(zendump_string_dup*), zendump_string_dup_compare);
+		for(idx = 0; idx < limit; ++idx) {
+			zend_string *preview, *str;
+			dup = dups[idx];
+			preview = zend_string_init(ZSTR_VAL(dup->str), MIN(ZSTR_LEN(dup->str), STRING_AUDIT_CONTENT_PREVIEW), 0);
+			str = zendump_unescape_zend_string(preview, 0);
+			php_printf("%*cstring(%zd,\"%s%s\") copies(%u) wasted(%zu)\n", INDENT_SIZE, ' ', ZSTR_LEN(dup->str), ZSTR_VAL(str), ZSTR_LEN(dup->str) > STRING_AUDIT_CONTENT_PREVIEW ? "..." : "", dup->count, (dup->count - 1) * dup->size);
+			if(str != preview) {
+				zend_string_release(str);
+			}
+			zend_string_release(preview);
+			php_printf("%*c%s\n", INDENT_SIZE << 1, ' ', ZSTR_VAL(dup->paths[0]));
+			php_printf("%*c%s\n", INDENT_SIZE << 1, ' ', ZSTR_VAL(dup->paths[1]));
+		}
+		efree(dups);
+	}
+	PUTS("}\n");
+
+	smart_str_free(&audit.path);
+	zend_hash_destroy(&audit.contents);
+	zend_hash_destroy(&audit.arrays);
+	zend_hash_destroy(&audit.strings);
+}
+
+static void zendump_literal_copy_record(zval *literal)
+{
+	zval *count;
+	if(!ZENDUMP_G(literal_copies)) {
+		ALLOC_HASHTABLE(ZENDUMP_G(literal_copies));
+		zend_hash_init(ZENDUMP_G(literal_copies), 16, NULL, NULL, 0);
+	}
+	count = zend_hash_index_find(ZENDUMP_G(literal_copies), (zend_ulong)(zend_uintptr_t)literal);
+	if(count) {
+		++Z_LVAL_P(count);
+	} else {
+		zval one;
+		ZVAL_LONG(&one, 1);
+		zend_hash_index_add_new(ZENDUMP_G(literal_copies), (zend_ulong)(zend_uintptr_t)literal, &one);
+	}
+}
+
+/* A constant array operand that did not come from opcache shared memory is
+   duplicated by the copy constructor each time one of these opcodes uses it. */
+void zendump_literal_copy_observe(zend_execute_data *execute_data, const zend_op *opline)
+{
+	zval *val;
+	switch(opline->opcode) {
+		case ZEND_ASSIGN:
+			if(opline->op2_type != IS_CONST) {
+				return;
+			}
+			val = zendump_operand_zval(execute_data, IS_CONST, &opline->op2);
+			break;
+		case ZEND_RECV_INIT:
+			if(opline->op1.num <= ZEND_CALL_NUM_ARGS(execute_data)) {
+				return;
+			}
+			val = zendump_operand_zval(execute_data, IS_CONST, &opline->op2);
+			break;
+		case ZEND_ASSIGN_DIM:
+		case ZEND_ASSIGN_OBJ:
+			if((opline + 1)->op1_type != IS_CONST) {
+				return;
+			}
+			val = zendump_operand_zval(execute_data, IS_CONST, &(opline + 1)->op1);
+			break;
+		default:
+			if(opline->op1_type != IS_CONST) {
+				return;
+			}
+			val = zendump_operand_zval(execute_data, IS_CONST, &opline->op1);
+	}
+	if(Z_TYPE_P(val) == IS_ARRAY && !(GC_FLAGS(Z_ARRVAL_P(val)) & IS_ARRAY_IMMUTABLE)) {
+		zendump_literal_copy_record(val);
+	}
+}
+
+void zendump_literal_copy_startup()
+{
+	const zend_uchar opcodes[] = {
+		ZEND_ASSIGN, ZEND_QM_ASSIGN, ZEND_RETURN, ZEND_SEND_VAL, ZEND_SEND_VAL_EX, ZEND_INIT_ARRAY,
+		ZEND_ADD_ARRAY_ELEMENT, ZEND_RECV_INIT, ZEND_YIELD, ZEND_ASSIGN_DIM, ZEND_ASSIGN_OBJ
+	};
+	int idx;
+	for(idx = 0; idx < ARRAY_LENGTH(opcodes); ++idx) {
+		zendump_observe_opcode(opcodes[idx], zendump_literal_copy_observe);
+	}
+}
+
+void zendump_literal_copy_reset()
+{
+	if(ZENDUMP_G(literal_copies)) {
+		zend_hash_destroy(ZENDUMP_G(literal_copies));
+		FREE_HASHTABLE(ZENDUMP_G(literal_copies));
+		ZENDUMP_G(literal_copies) = NULL;
+	}
+}
+
+static size_t zendump_array_size(zend_array *arr)
+{
+	size_t size = sizeof(zend_array);
+	if(arr->u.flags & HASH_FLAG_INITIALIZED) {
+		size += HT_USED_SIZE(arr);
+	}
+	return size;
+}
+
+static uint32_t zendump_literal_lineno(zend_op_array *op_array, zval *literal)
+{
+	uint32_t idx;
+	for(idx = 0; idx < op_array->last; ++idx) {
+		zend_op *opline = op_array->opcodes + idx;
+		if((opline->op1_type == IS_CONST && RT_CONSTANT(op_array, opline->op1) == literal) || (opline->op2_type == IS_CONST && RT_CONSTANT(op_array, opline->op2) == literal)) {
+			return opline->lineno;
+		}
+	}
+	return op_array->line_start;
+}
+
+static uint32_t zendump_immutable_audit_op_array(zend_op_array *op_array, HashTable *seen, zend_long min_elements)
+{
+	uint32_t idx, flagged = 0;
+	zval *copies;
+
+	if(!op_array->literals || !zend_hash_index_add_empty_element(seen, (zend_ulong)(zend_uintptr_t)op_array->opcodes)) {
+		return 0;
+	}
+	for(idx = 0; idx < op_array->last_literal; ++idx) {
+		zval *literal = op_array->literals + idx;
+		if(Z_TYPE_P(literal) != IS_ARRAY || (GC_FLAGS(Z_ARRVAL_P(literal)) & IS_ARRAY_IMMUTABLE) || zend_hash_num_elements(Z_ARRVAL_P(literal)) < min_elements) {
+			continue;
+		}
+		copies = ZENDUMP_G(literal_copies) ? zend_hash_index_find(ZENDUMP_G(literal_copies), (zend_ulong)(zend_uintptr_t)literal) : NULL;
+		php_printf("%*cop_array(\"%s%s%s\") literal(%u) array(%u) bytes(%zu) copies(" ZEND_LONG_FMT ") %s:%u\n", INDENT_SIZE, ' ',
+			(op_array->scope && op_array->scope->name) ? ZSTR_VAL(op_array->scope->name) : "", (op_array->scope && op_array->scope->name) ? "::" : "", op_array->function_name ? ZSTR_VAL(op_array->function_name) : "",
+			idx, zend_hash_num_elements(Z_ARRVAL_P(literal)), zendump_array_size(Z_ARRVAL_P(literal)), copies ? Z_LVAL_P(copies) : 0,
+			op_array->filename ? ZSTR_VAL(op_array->filename) : "", zendump_literal_lineno(op_array, literal));
+		++flagged;
+	}
+	return flagged;
+}
+
+static uint32_t zendump_immutable_audit_constants(zend_class_entry *ce, zend_long min_elements)
+{
+	zend_string *key;
+	zval *val;
+	uint32_t flagged = 0;
+
+	ZEND_HASH_FOREACH_STR_KEY_VAL(&ce->constants_table, key, val) {
+#if PHP_API_VERSION >= 20160303
+		val = &((zend_class_constant*)Z_PTR_P(val))->value;
+#endif
+		if(!key || Z_TYPE_P(val) != IS_ARRAY || (GC_FLAGS(Z_ARRVAL_P(val)) & IS_ARRAY_IMMUTABLE) || zend_hash_num_elements(Z_ARRVAL_P(val)) < min_elements) {
+			continue;
+		}
+		php_printf("%*cclass_constant(\"%s::%s\") array(%u) bytes(%zu) %s:%u\n", INDENT_SIZE, ' ', ZSTR_VAL(ce->name), ZSTR_VAL(key), zend_hash_num_elements(Z_ARRVAL_P(val)), zendump_array_size(Z_ARRVAL_P(val)), ce->info.user.filename ? ZSTR_VAL(ce->info.user.filename) : "", ce->info.user.line_start);
+		++flagged;
+	} ZEND_HASH_FOREACH_END();
+	return flagged;
+}
+
+void zendump_immutable_audit(zend_long min_elements)
+{
+	HashTable seen;
+	zend_execute_data *ex;
+	zend_class_entry *ce;
+	zend_function *func;
+	uint32_t flagged = 0;
+
+	zend_hash_init(&seen, 64, NULL, NULL, 0);
+	PUTS("immutable_audit: {\n");
+	for(ex = EG(current_execute_data); ex; ex = ex->prev_execute_data) {
+		if(ex->func && ZEND_USER_CODE(ex->func->type)) {
+			flagged += zendump_immutable_audit_op_array(&ex->func->op_array, &seen, min_elements);
+		}
+	}
+	ZEND_HASH_FOREACH_PTR(EG(function_table), func) {
+		if(func->type == ZEND_USER_FUNCTION) {
+			flagged += zendump_immutable_audit_op_array(&func->op_array, &seen, min_elements);
+		}
+	} ZEND_HASH_FOREACH_END();
+	ZEND_HASH_FOREACH_PTR(EG(class_table), ce) {
+		if(ce->type != ZEND_USER_CLASS) {
+			continue;
+		}
+		ZEND_HASH_FOREACH_PTR(&ce->function_table, func) {
+			if(func->type == ZEND_USER_FUNCTION) {
+				flagged += zendump_immutable_audit_op_array(&func->op_array, &seen, min_elements);
+			}
+		} ZEND_HASH_FOREACH_END();
+		flagged += zendump_immutable_audit_constants(ce, min_elements);
+	} ZEND_HASH_FOREACH_END();
+	php_printf("} flagged(%u)\n", flagged);
+	zend_hash_destroy(&seen);
+}
@@ -38,6 +38,8 @@ extern zend_module_entry zendump_module_entry;
 #include "TSRM.h"
 #endif
 
+#include "zend_smart_str_public.h"
+
 #ifdef ZEND_ENABLE_ZVAL_LONG64
 # define ZEND_XLONG_FMT_SPEC PRIx64
 #else
@@ -61,13 +63,79 @@ extern zend_module_entry zendump_module_entry;
 # define ZEND_VM_OP2_FLAGS(f) (f)
 #endif
 
+/*
+ * The watchdog relies on the VM interrupt of PHP 7.1 and signals it from a
+ * timer thread, which only works with the non-thread-safe globals.
+ */
+#if !defined(ZTS) && PHP_API_VERSION >= 20160303 && defined(HAVE_TIMER_CREATE)
+# define ZENDUMP_WATCHDOG 1
+#endif
+
 #define ARRAY_LENGTH(a) (sizeof(a)/sizeof(a[0]))
 
 #define EX_OFFSET_TO_VAR_IDX(offset) ((zval*)((zend_long)offset - sizeof(zend_execute_data)) - (zval*)0)
 
 #define INDENT_SIZE 2
 
+/*
+ * For PHP 7.0
+ */
+#ifndef OBJ_PROP_TO_OFFSET
+# define OBJ_PROP_TO_OFFSET(num) ((uint32_t)(XtOffsetOf(zend_object, properties_table) + sizeof(zval) * (num)))
+#endif
+#ifndef OBJ_PROP_TO_NUM
+# define OBJ_PROP_TO_NUM(offset) (((offset) - OBJ_PROP_TO_OFFSET(0)) / sizeof(zval))
+#endif
+
 typedef void (*execute_func)(zend_execute_data *);
+typedef struct _zendump_class_layout {
+    uint32_t     properties_count;
+    uint32_t     static_members_count;
+    zend_string  **names; /* declared slots first, then static members */
+} zendump_class_layout;
+
+typedef struct _zendump_pending_object {
+    zend_object  *obj;
+    uint32_t     handle;
+    zend_uchar   opcode;
+    uint32_t     lineno;
+    zend_string  *filename;
+} zendump_pending_object;
+
+typedef struct _zendump_op_array_profile {
+    const zend_op  *opcodes;
+    uint32_t       last;
+    uint32_t       source_start;
+    uint32_t       source_end;
+    zend_string    *filename;
+    zend_string    *function_name;
+    zend_string    *scope_name;
+    uint64_t       *hits;
+    uint32_t       line_start;
+    uint32_t       line_count;
+    uint64_t       *line_hits;
+    uint64_t       *line_time;
+    HashTable      *loops;
+    zend_uchar     *coverage;
+    uint32_t       coverage_line_start;
+    uint32_t       coverage_line_count;
+    zend_uchar     *coverage_lines;
+    zend_uchar     *coverage_executable;
+    HashTable      *cache_sites;
+    struct _zendump_type_slot *types;
+    uint32_t       types_count;
+} zendump_op_array_profile;
+
+typedef struct _zendump_loop {
+    uint32_t     header;
+    uint32_t     latch;
+    uint32_t     line_start;
+    uint32_t     line_end;
+    uint64_t     iterations;
+    uint64_t     entries;
+} zendump_loop;
+
+typedef void (*zendump_opcode_observer)(zend_execute_data *execute_data, const zend_op *opline);
 
 /*
   	Declare any global variables you may need between the BEGIN
@@ -78,6 +146,71 @@ ZEND_BEGIN_MODULE_GLOBALS(zendump)
     execute_func origin_execute;
     zend_long    global_value;
     char         *global_string;
+    zend_bool    enable_cow_trace;
+    HashTable    *cow_sites;
+    HashTable    *class_layouts;
+    zend_bool    enable_properties_trace;
+    HashTable    *properties_sites;
+    uint32_t     properties_pending_count;
+    zendump_pending_object properties_pending[8];
+    zend_bool    enable_immutable_trace;
+    HashTable    *literal_copies;
+    zend_bool    enable_opcode_profile;
+    HashTable    *profiles;
+    zendump_op_array_profile *profile_cache;
+    uint64_t     opcode_hits[256];
+    zend_bool    enable_line_profile;
+    zendump_op_array_profile *line_last_profile;
+    uint32_t     line_last_index;
+    uint64_t     line_last_time;
+    zend_bool    enable_loop_profile;
+    zend_long    loop_report_limit;
+    zend_bool    enable_coverage;
+    zend_bool    coverage_active;
+    zend_bool    enable_compile_profile;
+    zend_op_array *(*origin_compile_file)(zend_file_handle *file_handle, int type);
+    zend_op_array *(*origin_compile_string)(zval *source_string, char *filename);
+    HashTable    *compile_sites;
+    zend_bool    enable_autoload_trace;
+    void         (*origin_execute_internal)(zend_execute_data *execute_data, zval *return_value);
+    HashTable    *autoload_sites;
+    HashTable    *autoload_pool;
+    uint32_t     autoload_depth;
+    uint64_t     autoload_requests;
+    zend_bool    enable_preload_trace;
+    HashTable    *preload_files;
+    HashTable    *preload_seen;
+    zend_bool    preload_counted;
+    uint64_t     preload_requests;
+    zend_bool    enable_cache_profile;
+    zend_bool    enable_receiver_profile;
+    HashTable    *receiver_sites;
+    zend_bool    enable_type_profile;
+    zend_bool    enable_gc_profile;
+    zend_bool    gc_recording;
+    int          (*origin_gc_collect_cycles)(void);
+    struct _zendump_gc_run *gc_runs;
+    uint32_t     gc_runs_count;
+    uint32_t     gc_runs_size;
+    HashTable    *gc_garbage;
+    zend_bool    enable_error_trace;
+    zend_bool    error_recording;
+    void         (*origin_error_cb)(int type, const char *error_filename, const uint32_t error_lineno, const char *format, va_list args);
+    void         (*origin_throw_exception_hook)(zval *ex);
+    HashTable    *exception_origins;
+    HashTable    *error_sites;
+    HashTable    *error_pool;
+    uint64_t     error_requests;
+    zend_long    watchdog_threshold;
+    char         *watchdog_log;
+    zend_long    watchdog_max_size;
+    zend_long    backtrace_buffer_size;
+    char         *backtrace_log;
+    struct _zendump_backtrace_frame *backtrace_frames;
+    uint32_t     backtrace_frames_used;
+    struct _zendump_backtrace *backtraces;
+    uint32_t     backtrace_count;
+    uint32_t     backtrace_size;
 ZEND_END_MODULE_GLOBALS(zendump)
 
 
@@ -99,16 +232,121 @@ void zendump_zval_dump(zval *val, int level);
 void zendump_zend_array_dump(zend_array *arr, int level);
 
 void zendump_zend_function_proto_dump(zend_function *function, int level);
+void zendump_zend_function_proto_append(smart_str *buf, zend_function *function);
 void zendump_zend_function_dump(zend_function *function, int column_width);
+void zendump_codebase_stats(zend_long limit, int column_width);
 
 void zendump_zend_class_entry_dump(zend_class_entry *ce, int show_magic_functions, int column_width);
 void zendump_static_properties_dump(zend_class_entry *ce, int level);
 void zendump_properties_dump(zend_object *obj, int level);
+zendump_class_layout *zendump_class_layout_get(zend_class_entry *ce);
+void zendump_class_layout_dump(zend_class_entry *ce);
+void zendump_class_layout_reset();
 
 size_t zendump_errorf(const char *format, ...);
+uint64_t zendump_time_ns();
+void *zendump_pool_record(HashTable **pool, const char *key, size_t key_len, size_t size, dtor_func_t dtor);
+void zendump_pool_destroy(HashTable **pool);
+void zendump_zval_summary_append(smart_str *buf, zval *val);
 
 void zendump_execute(zend_execute_data *ex);
 
+int zendump_observe_opcode(zend_uchar opcode, zendump_opcode_observer observer);
+int zendump_observe_all_opcodes(zendump_opcode_observer observer);
+void zendump_unobserve_opcodes();
+zval *zendump_operand_zval(zend_execute_data *execute_data, zend_uchar type, const znode_op *op);
+const zend_op *zendump_smart_branch_jump(zend_op_array *op_array, const zend_op *opline);
+
+void zendump_cow_observe(zend_execute_data *execute_data, const zend_op *opline);
+void zendump_cow_startup();
+void zendump_cow_report(zend_long limit);
+void zendump_cow_reset();
+
+void zendump_properties_observe(zend_execute_data *execute_data, const zend_op *opline);
+void zendump_objects_survey(zend_long limit);
+void zendump_properties_reset();
+
+void zendump_string_audit(zend_long limit);
+
+void zendump_literal_copy_observe(zend_execute_data *execute_data, const zend_op *opline);
+void zendump_literal_copy_startup();
+void zendump_literal_copy_reset();
+void zendump_immutable_audit(zend_long min_elements);
+
+zendump_op_array_profile *zendump_profile_find(zend_op_array *op_array, int create);
+void zendump_profile_reset();
+void zendump_opcode_profile_observe(zend_execute_data *execute_data, const zend_op *opline);
+void zendump_opcode_mix_dump(zend_long limit, int column_width);
+void zendump_line_profile_observe(zend_execute_data *execute_data, const zend_op *opline);
+void zendump_line_profile_collect(zval *result);
+int zendump_line_profile_callgrind(const char *filename);
+void zendump_loop_profile_observe(zend_execute_data *execute_data, const zend_op *opline);
+void zendump_loop_profile_startup();
+void zendump_hot_loops_dump(zend_long limit, int to_stderr);
+
+void zendump_coverage_observe(zend_execute_data *execute_data, const zend_op *opline);
+void zendump_coverage_start();
+void zendump_coverage_stop(zval *result);
+
+void zendump_compile_profile_startup();
+void zendump_compile_profile_shutdown();
+void zendump_compile_profile_dump(zend_long limit);
+void zendump_compile_profile_reset();
+void zendump_isolated_tables_init(HashTable *functions, HashTable *classes);
+void zendump_isolated_tables_destroy(HashTable *functions, HashTable *classes);
+zend_op_array *zendump_compile_isolated(const char *filename, int raw, HashTable *functions, HashTable *classes);
+void zendump_isolated_op_array_free(zend_op_array *op_array);
+int zendump_optimizer_diff(const char *filename);
+int zendump_file_dump(const char *filename, int column_width);
+zend_long zendump_file_batch(const char *path, const char *output, int column_width);
+
+void zendump_autoload_startup();
+void zendump_autoload_shutdown();
+void zendump_autoload_dump(zend_long limit, zend_bool pool);
+void zendump_autoload_reset();
+
+void zendump_preload_observe();
+zend_long zendump_preload_script(const char *filename, double min_ratio);
+void zendump_preload_reset();
+void zendump_preload_shutdown();
+
+void zendump_runtime_cache_dump(zend_op_array *op_array);
+void zendump_runtime_cache_observe(zend_execute_data *execute_data, const zend_op *opline);
+void zendump_runtime_cache_startup();
+void zendump_receiver_observe(zend_execute_data *execute_data, const zend_op *opline);
+void zendump_receiver_dump(zend_long limit, zend_long min_classes);
+void zendump_receiver_startup();
+void zendump_receiver_shutdown();
+
+void zendump_type_profile_free(zendump_op_array_profile *profile);
+void zendump_type_profile_enter(zend_execute_data *execute_data);
+void zendump_type_profile_observe(zend_execute_data *execute_data, const zend_op *opline);
+void zendump_type_profile_dump(zend_long limit, zend_bool hintable_only);
+
+void zendump_gc_profile_startup();
+void zendump_gc_profile_shutdown();
+void zendump_gc_profile_dump(zend_long limit);
+void zendump_gc_profile_reset();
+
+void zendump_error_trace_startup();
+void zendump_error_trace_shutdown();
+void zendump_error_trace_dump(zend_long limit, zend_bool pool);
+void zendump_error_trace_reset();
+
+void zendump_watchdog_startup();
+void zendump_watchdog_shutdown();
+void zendump_watchdog_activate();
+void zendump_watchdog_deactivate();
+
+zend_long zendump_backtrace_capture(zend_execute_data *ex, zend_long limit, zend_bool with_args);
+zend_string *zendump_backtrace_format(zend_long handle);
+void zendump_backtrace_reset();
+
+zend_long zendump_diff(zval *a, zval *b, zend_long limit);
+
+uint32_t zendump_jump_targets(zend_op_array *op_array, zend_op *opline, uint32_t *targets, uint32_t size, int *falls_through);
+zend_string *zendump_cfg_export(zend_op_array *op_array, int json);
+
 #endif	/* PHP_ZENDUMP_H */
 
 
@@ -0,0 +1,182 @@
+/*
+  +----------------------------------------------------------------------+
+  | PHP Version 7                                                        |
+  +----------------------------------------------------------------------+
+  | Copyright (c) 1997-2018 The PHP Group                                |
+  +----------------------------------------------------------------------+
+  | This source file is subject to version 3.01 of the PHP license,      |
+  | that is bundled with this package in the file LICENSE, and is        |
+  | available through the world-wide-web at the following url:           |
+  | http://www.php.net/license/3_01.txt                                  |
+  | If you did not receive a copy of the PHP license and are unable to   |
+  | obtain it through the world-wide-web, please send a note to          |
+  | license@php.net so we can mail you a copy immediately.               |
+  +----------------------------------------------------------------------+
+  | Author: Youlin Feng <fengyoulin@php7th.com>                          |
+  +----------------------------------------------------------------------+
+*/
+
+/* $Id$ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "php.h"
+#include "php_ini.h"
+#include "ext/standard/info.h"
+#include "php_zendump.h"
+
+ZEND_EXTERN_MODULE_GLOBALS(zendump)
+
+typedef struct _zendump_preload_file {
+	uint64_t  requests;
+	HashTable deps;
+} zendump_preload_file;
+
+static void zendump_preload_file_dtor(zval *zv)
+{
+	zendump_preload_file *file = (zendump_preload_file*)Z_PTR_P(zv);
+	zend_hash_destroy(&file->deps);
+	pefree(file, 1);
+}
+
+static zendump_preload_file *zendump_preload_file_get(zend_string *filename)
+{
+	zendump_preload_file *file;
+
+	if(!ZENDUMP_G(preload_files)) {
+		ZENDUMP_G(preload_files) = pemalloc(sizeof(HashTable), 1);
+		zend_hash_init(ZENDUMP_G(preload_files), 64, NULL, zendump_preload_file_dtor, 1);
+	}
+	file = zend_hash_str_find_ptr(ZENDUMP_G(preload_files), ZSTR_VAL(filename), ZSTR_LEN(filename));
+	if(!file) {
+		file = pecalloc(1, sizeof(zendump_preload_file), 1);
+		zend_hash_init(&file->deps, 4, NULL, NULL, 1);
+		zend_hash_str_add_new_ptr(ZENDUMP_G(preload_files), ZSTR_VAL(filename), ZSTR_LEN(filename), file);
+	}
+	if(!ZENDUMP_G(preload_seen)) {
+		ALLOC_HASHTABLE(ZENDUMP_G(preload_seen));
+		zend_hash_init(ZENDUMP_G(preload_seen), 64, NULL, NULL, 0);
+	}
+	if(zend_hash_add_empty_element(ZENDUMP_G(preload_seen), filename)) {
+		++file->requests;
+	}
+	return file;
+}
+
+static void zendump_preload_dep(zendump_preload_file *file, zend_string *filename, zend_class_entry *dep)
+{
+	if(!dep || dep->type != ZEND_USER_CLASS || !dep->info.user.filename || zend_string_equals(dep->info.user.filename, filename)) {
+		return;
+	}
+	zendump_preload_file_get(dep->info.user.filename);
+	zend_hash_str_add_empty_element(&file->deps, ZSTR_VAL(dep->info.user.filename), ZSTR_LEN(dep->info.user.filename));
+}
+
+/* Merges the user classes and functions loaded by the current request into
+   the pool-wide table. A class depends on the files that declare its parent,
+   interfaces and traits, which must be compiled before it can be linked. */
+void zendump_preload_observe()
+{
+	zendump_preload_file *file;
+	zend_class_entry *ce;
+	zend_function *func;
+	uint32_t idx;
+
+	if(!ZENDUMP_G(preload_counted)) {
+		ZENDUMP_G(preload_counted) = 1;
+		++ZENDUMP_G(preload_requests);
+	}
+	ZEND_HASH_FOREACH_PTR(EG(function_table), func) {
+		if(func->type == ZEND_USER_FUNCTION && func->op_array.filename) {
+			zendump_preload_file_get(func->op_array.filename);
+		}
+	} ZEND_HASH_FOREACH_END();
+	ZEND_HASH_FOREACH_PTR(EG(class_table), ce) {
+		if(ce->type != ZEND_USER_CLASS || !ce->info.user.filename) {
+			continue;
+		}
+		file = zendump_preload_file_get(ce->info.user.filename);
+		zendump_preload_dep(file, ce->info.user.filename, ce->parent);
+		if(ce->interfaces) {
+			for(idx = 0; idx < ce->num_interfaces; ++idx) {
+				zendump_preload_dep(file, ce->info.user.filename, ce->interfaces[idx]);
+			}
+		}
+		if(ce->traits) {
+			for(idx = 0; idx < ce->num_traits; ++idx) {
+				zendump_preload_dep(file, ce->info.user.filename, ce->traits[idx]);
+			}
+		}
+	} ZEND_HASH_FOREACH_END();
+}
+
+static void zendump_preload_visit(php_stream *stream, zend_string *name, HashTable *visited, uint32_t *count)
+{
+	zendump_preload_file *file = zend_hash_find_ptr(ZENDUMP_G(preload_files), name);
+	zend_string *dep;
+	size_t idx;
+
+	if(!file || !zend_hash_add_empty_element(visited, name)) {
+		return;
+	}
+	ZEND_HASH_FOREACH_STR_KEY(&file->deps, dep) {
+		zendump_preload_visit(stream, dep, visited, count);
+	} ZEND_HASH_FOREACH_END();
+	php_stream_write(stream, "opcache_compile_file('", sizeof("opcache_compile_file('") - 1);
+	for(idx = 0; idx < ZSTR_LEN(name); ++idx) {
+		if(ZSTR_VAL(name)[idx] == '\'' || ZSTR_VAL(name)[idx] == '\\') {
+			php_stream_putc(stream, '\\');
+		}
+		php_stream_putc(stream, ZSTR_VAL(name)[idx]);
+	}
+	php_stream_write(stream, "');\n", sizeof("');\n") - 1);
+	++*count;
+}
+
+/* Writes the files seen in at least min_ratio of the requests, each one
+   after the files it depends on even when those are not hot themselves. */
+zend_long zendump_preload_script(const char *filename, double min_ratio)
+{
+	zendump_preload_file *file;
+	zend_string *name;
+	php_stream *stream;
+	HashTable visited;
+	uint32_t count = 0;
+
+	zendump_preload_observe();
+
+	stream = php_stream_open_wrapper((char*)filename, "wb", REPORT_ERRORS, NULL);
+	if(!stream) {
+		return -1;
+	}
+	php_stream_printf(stream, "<?php\n/* Generated by zendump %s from %" PRIu64 " requests, files seen in at least %.0f%% of them. */\n", PHP_ZENDUMP_VERSION, ZENDUMP_G(preload_requests), min_ratio * 100);
+	if(ZENDUMP_G(preload_files)) {
+		zend_hash_init(&visited, 64, NULL, NULL, 0);
+		ZEND_HASH_FOREACH_STR_KEY_PTR(ZENDUMP_G(preload_files), name, file) {
+			if(file->requests >= min_ratio * ZENDUMP_G(preload_requests)) {
+				zendump_preload_visit(stream, name, &visited, &count);
+			}
+		} ZEND_HASH_FOREACH_END();
+		zend_hash_destroy(&visited);
+	}
+	php_stream_close(stream);
+	return count;
+}
+
+void zendump_preload_reset()
+{
+	zendump_preload_observe();
+	if(ZENDUMP_G(preload_seen)) {
+		zend_hash_destroy(ZENDUMP_G(preload_seen));
+		FREE_HASHTABLE(ZENDUMP_G(preload_seen));
+		ZENDUMP_G(preload_seen) = NULL;
+	}
+	ZENDUMP_G(preload_counted) = 0;
+}
+
+void zendump_preload_shutdown()
+{
+	zendump_pool_destroy(&ZENDUMP_G(preload_files));
+}
@@ -0,0 +1,700 @@
+/*
+  +----------------------------------------------------------------------+
+  | PHP Version 7                                                        |
+  +----------------------------------------------------------------------+
+  | Copyright (c) 1997-2018 The PHP Group                                |
+  +----------------------------------------------------------------------+
+  | This source file is subject to version 3.01 of the PHP license,      |
+  | that is bundled with this package in the file LICENSE, and is        |
+  | available through the world-wide-web at the following url:           |
+  | http://www.php.net/license/3_01.txt                                  |
+  | If you did not receive a copy of the PHP license and are unable to   |
+  | obtain it through the world-wide-web, please send a note to          |
+  | license@php.net so we can mail you a copy immediately.               |
+  +----------------------------------------------------------------------+
+  | Author: Youlin Feng <fengyoulin@php7th.com>                          |
+  +----------------------------------------------------------------------+
+*/
+
+/* $Id$ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "php.h"
+#include "php_ini.h"
+#include "ext/standard/info.h"
+#include "php_zendump.h"
+
+ZEND_EXTERN_MODULE_GLOBALS(zendump)
+
+static void zendump_profile_dtor(zval *zv)
+{
+	zendump_op_array_profile *profile = (zendump_op_array_profile*)Z_PTR_P(zv);
+	if(profile->filename) {
+		zend_string_release(profile->filename);
+	}
+	if(profile->function_name) {
+		zend_string_release(profile->function_name);
+	}
+	if(profile->scope_name) {
+		zend_string_release(profile->scope_name);
+	}
+	if(profile->hits) {
+		efree(profile->hits);
+	}
+	if(profile->line_hits) {
+		efree(profile->line_hits);
+		efree(profile->line_time);
+	}
+	if(profile->coverage) {
+		efree(profile->coverage);
+		efree(profile->coverage_lines);
+		efree(profile->coverage_executable);
+	}
+	if(profile->types) {
+		zendump_type_profile_free(profile);
+	}
+	if(profile->cache_sites) {
+		zend_hash_destroy(profile->cache_sites);
+		FREE_HASHTABLE(profile->cache_sites);
+	}
+	if(profile->loops) {
+		zend_hash_destroy(profile->loops);
+		FREE_HASHTABLE(profile->loops);
+	}
+	if(ZENDUMP_G(line_last_profile) == profile) {
+		ZENDUMP_G(line_last_profile) = NULL;
+	}
+	efree(profile);
+}
+
+static zendump_op_array_profile *zendump_profile_create(zend_op_array *op_array)
+{
+	zendump_op_array_profile *profile = ecalloc(1, sizeof(zendump_op_array_profile));
+	profile->opcodes = op_array->opcodes;
+	profile->last = op_array->last;
+	profile->source_start = op_array->line_start;
+	profile->source_end = op_array->line_end;
+	profile->filename = op_array->filename ? zend_string_copy(op_array->filename) : NULL;
+	profile->function_name = op_array->function_name ? zend_string_copy(op_array->function_name) : NULL;
+	profile->scope_name = (op_array->scope && op_array->scope->name) ? zend_string_copy(op_array->scope->name) : NULL;
+	if(ZENDUMP_G(enable_opcode_profile)) {
+		profile->hits = ecalloc(op_array->last, sizeof(uint64_t));
+	}
+	if(ZENDUMP_G(enable_line_profile) && op_array->last) {
+		uint32_t idx, line_end = 0;
+		profile->line_start = op_array->opcodes[0].lineno;
+		for(idx = 0; idx < op_array->last; ++idx) {
+			if(op_array->opcodes[idx].lineno < profile->line_start) {
+				profile->line_start = op_array->opcodes[idx].lineno;
+			}
+			if(op_array->opcodes[idx].lineno > line_end) {
+				line_end = op_array->opcodes[idx].lineno;
+			}
+		}
+		profile->line_count = line_end - profile->line_start + 1;
+		profile->line_hits = ecalloc(profile->line_count, sizeof(uint64_t));
+		profile->line_time = ecalloc(profile->line_count, sizeof(uint64_t));
+	}
+	return profile;
+}
+
+static zend_always_inline int zendump_profile_matches(zendump_op_array_profile *profile, zend_op_array *op_array)
+{
+	return profile->opcodes == op_array->opcodes &&
+		profile->last == op_array->last &&
+		profile->source_start == op_array->line_start &&
+		profile->source_end == op_array->line_end &&
+		(profile->filename == op_array->filename || (profile->filename && op_array->filename && zend_string_equals(profile->filename, op_array->filename)));
+}
+
+/* Records are keyed by the opcodes address rather than stored in a reserved
+   slot, because op_arrays served from opcache live in read-only shared memory.
+   The main op_array of an included file is freed once it ran, and the next
+   one often gets the same address. Its record then describes other code, so
+   it is moved to a key of its own, where its counters are still reported,
+   and a new record takes the address. */
+zendump_op_array_profile *zendump_profile_find(zend_op_array *op_array, int create)
+{
+	zendump_op_array_profile *profile = ZENDUMP_G(profile_cache);
+	zval *zv;
+
+	if(profile && zendump_profile_matches(profile, op_array)) {
+		return profile;
+	}
+	if(!ZENDUMP_G(profiles)) {
+		if(!create) {
+			return NULL;
+		}
+		ALLOC_HASHTABLE(ZENDUMP_G(profiles));
+		zend_hash_init(ZENDUMP_G(profiles), 64, NULL, zendump_profile_dtor, 0);
+	}
+	zv = zend_hash_index_find(ZENDUMP_G(profiles), (zend_ulong)(zend_uintptr_t)op_array->opcodes);
+	if(zv && zendump_profile_matches((zendump_op_array_profile*)Z_PTR_P(zv), op_array)) {
+		profile = (zendump_op_array_profile*)Z_PTR_P(zv);
+	} else if(!create) {
+		return NULL;
+	} else {
+		profile = zendump_profile_create(op_array);
+		if(zv) {
+			zendump_op_array_profile *stale = (zendump_op_array_profile*)Z_PTR_P(zv);
+			Z_PTR_P(zv) = profile;
+			zend_hash_index_add_new_ptr(ZENDUMP_G(profiles), (zend_ulong)(zend_uintptr_t)stale, stale);
+		} else {
+			zend_hash_index_add_new_ptr(ZENDUMP_G(profiles), (zend_ulong)(zend_uintptr_t)op_array->opcodes, profile);
+		}
+	}
+	ZENDUMP_G(profile_cache) = profile;
+	return profile;
+}
+
+void zendump_profile_reset()
+{
+	ZENDUMP_G(profile_cache) = NULL;
+	ZENDUMP_G(line_last_profile) = NULL;
+	if(ZENDUMP_G(profiles)) {
+		zend_hash_destroy(ZENDUMP_G(profiles));
+		FREE_HASHTABLE(ZENDUMP_G(profiles));
+		ZENDUMP_G(profiles) = NULL;
+	}
+	memset(ZENDUMP_G(opcode_hits), 0, sizeof(ZENDUMP_G(opcode_hits)));
+}
+
+void zendump_opcode_profile_observe(zend_execute_data *execute_data, const zend_op *opline)
+{
+	zend_op_array *op_array = &EX(func)->op_array;
+	zendump_op_array_profile *profile = zendump_profile_find(op_array, 1);
+	uint32_t num = opline - op_array->opcodes;
+	const zend_op *jump = zendump_smart_branch_jump(op_array, opline);
+
+	++ZENDUMP_G(opcode_hits)[opline->opcode];
+	if(num < profile->last) {
+		++profile->hits[num];
+	}
+	/* The fused jump is counted with the opline that performs it. */
+	if(jump) {
+		++ZENDUMP_G(opcode_hits)[jump->opcode];
+		++profile->hits[jump - op_array->opcodes];
+	}
+}
+
+static int zendump_opcode_mix_compare(const void *a, const void *b)
+{
+	uint64_t x = ZENDUMP_G(opcode_hits)[*(const zend_uchar*)a];
+	uint64_t y = ZENDUMP_G(opcode_hits)[*(const zend_uchar*)b];
+	if(x != y) {
+		return x < y ? 1 : -1;
+	}
+	return (int)*(const zend_uchar*)a - (int)*(const zend_uchar*)b;
+}
+
+void zendump_opcode_mix_dump(zend_long limit, int column_width)
+{
+	zend_uchar opcodes[256];
+	uint64_t total = 0;
+	uint32_t idx, count = 0;
+
+	for(idx = 0; idx < ARRAY_LENGTH(opcodes); ++idx) {
+		if(ZENDUMP_G(opcode_hits)[idx]) {
+			opcodes[count++] = (zend_uchar)idx;
+			total += ZENDUMP_G(opcode_hits)[idx];
+		}
+	}
+	qsort(opcodes, count, sizeof(zend_uchar), zendump_opcode_mix_compare);
+	if(limit <= 0 || limit > count) {
+		limit = count;
+	}
+	php_printf("opcode_mix(%u) total(%" PRIu64 "): {\n", count, total);
+	for(idx = 0; idx < limit; ++idx) {
+		uint64_t hits = ZENDUMP_G(opcode_hits)[opcodes[idx]];
+		php_printf("%*c%-*s%-*" PRIu64 "%.2f%%\n", INDENT_SIZE, ' ', column_width, zend_get_opcode_name(opcodes[idx]), column_width, hits, hits * 100.0 / total);
+	}
+	PUTS("}\n");
+}
+
+/* The time since the previous opcode is charged to the line of that opcode,
+   so every line is credited with its exclusive cost including internal calls. */
+void zendump_line_profile_observe(zend_execute_data *execute_data, const zend_op *opline)
+{
+	uint64_t now = zendump_time_ns();
+	zend_op_array *op_array = &EX(func)->op_array;
+	zendump_op_array_profile *profile;
+
+	if(ZENDUMP_G(line_last_profile)) {
+		ZENDUMP_G(line_last_profile)->line_time[ZENDUMP_G(line_last_index)] += now - ZENDUMP_G(line_last_time);
+		ZENDUMP_G(line_last_profile) = NULL;
+	}
+	if((uint32_t)(opline - op_array->opcodes) >= op_array->last) {
+		return;
+	}
+	profile = zendump_profile_find(op_array, 1);
+	if(!profile->line_hits || opline->lineno < profile->line_start || opline->lineno - profile->line_start >= profile->line_count) {
+		return;
+	}
+	++profile->line_hits[opline->lineno - profile->line_start];
+	ZENDUMP_G(line_last_profile) = profile;
+	ZENDUMP_G(line_last_index) = opline->lineno - profile->line_start;
+	ZENDUMP_G(line_last_time) = zendump_time_ns();
+}
+
+void zendump_line_profile_collect(zval *result)
+{
+	zendump_op_array_profile *profile;
+	zval *file, *line, entry;
+	uint32_t idx;
+
+	array_init(result);
+	if(!ZENDUMP_G(profiles)) {
+		return;
+	}
+	ZEND_HASH_FOREACH_PTR(ZENDUMP_G(profiles), profile) {
+		if(!profile->line_hits || !profile->filename) {
+			continue;
+		}
+		file = zend_hash_find(Z_ARRVAL_P(result), profile->filename);
+		if(!file) {
+			array_init(&entry);
+			file = zend_hash_add_new(Z_ARRVAL_P(result), profile->filename, &entry);
+		}
+		for(idx = 0; idx < profile->line_count; ++idx) {
+			if(!profile->line_hits[idx]) {
+				continue;
+			}
+			line = zend_hash_index_find(Z_ARRVAL_P(file), profile->line_start + idx);
+			if(!line) {
+				array_init_size(&entry, 2);
+				add_next_index_long(&entry, 0);
+				add_next_index_long(&entry, 0);
+				line = zend_hash_index_add_new(Z_ARRVAL_P(file), profile->line_start + idx, &entry);
+			}
+			Z_LVAL_P(zend_hash_index_find(Z_ARRVAL_P(line), 0)) += profile->line_hits[idx];
+			Z_LVAL_P(zend_hash_index_find(Z_ARRVAL_P(line), 1)) += profile->line_time[idx];
+		}
+	} ZEND_HASH_FOREACH_END();
+}
+
+int zendump_line_profile_callgrind(const char *filename)
+{
+	zendump_op_array_profile *profile;
+	php_stream *stream;
+	uint32_t idx;
+
+	stream = php_stream_open_wrapper((char*)filename, "wb", REPORT_ERRORS, NULL);
+	if(!stream) {
+		return FAILURE;
+	}
+	php_stream_printf(stream, "version: 1\ncreator: zendump %s\npositions: line\nevents: Hits Nanoseconds\n", PHP_ZENDUMP_VERSION);
+	if(ZENDUMP_G(profiles)) {
+		ZEND_HASH_FOREACH_PTR(ZENDUMP_G(profiles), profile) {
+			if(!profile->line_hits || !profile->filename) {
+				continue;
+			}
+			php_stream_printf(stream, "\nfl=%s\nfn=%s%s%s\n", ZSTR_VAL(profile->filename), profile->scope_name ? ZSTR_VAL(profile->scope_name) : "", profile->scope_name ? "::" : "", profile->function_name ? ZSTR_VAL(profile->function_name) : "{main}");
+			for(idx = 0; idx < profile->line_count; ++idx) {
+				if(profile->line_hits[idx]) {
+					php_stream_printf(stream, "%u %" PRIu64 " %" PRIu64 "\n", profile->line_start + idx, profile->line_hits[idx], profile->line_time[idx]);
+				}
+			}
+		} ZEND_HASH_FOREACH_END();
+	}
+	php_stream_close(stream);
+	return SUCCESS;
+}
+
+static void zendump_loop_dtor(zval *zv)
+{
+	efree(Z_PTR_P(zv));
+}
+
+static zendump_loop *zendump_loop_find(zend_op_array *op_array, uint32_t header)
+{
+	zendump_op_array_profile *profile = zendump_profile_find(op_array, 1);
+	zendump_loop *loop;
+
+	if(!profile->loops) {
+		ALLOC_HASHTABLE(profile->loops);
+		zend_hash_init(profile->loops, 8, NULL, zendump_loop_dtor, 0);
+	}
+	loop = zend_hash_index_find_ptr(profile->loops, header);
+	if(!loop) {
+		loop = emalloc(sizeof(zendump_loop));
+		memset(loop, 0, sizeof(zendump_loop));
+		loop->header = header;
+		loop->latch = header;
+		loop->line_start = loop->line_end = op_array->opcodes[header].lineno;
+		zend_hash_index_add_new_ptr(profile->loops, header, loop);
+	}
+	return loop;
+}
+
+static void zendump_loop_latch(zend_op_array *op_array, zendump_loop *loop, uint32_t latch)
+{
+	uint32_t idx;
+	if(latch <= loop->latch) {
+		return;
+	}
+	for(idx = loop->latch + 1; idx <= latch; ++idx) {
+		if(op_array->opcodes[idx].lineno < loop->line_start) {
+			loop->line_start = op_array->opcodes[idx].lineno;
+		}
+		if(op_array->opcodes[idx].lineno > loop->line_end) {
+			loop->line_end = op_array->opcodes[idx].lineno;
+		}
+	}
+	loop->latch = latch;
+}
+
+static void zendump_loop_branch(zend_op_array *op_array, uint32_t num, uint32_t taken, uint32_t other)
+{
+	zendump_loop *loop;
+
+	if(taken < num) {
+		loop = zendump_loop_find(op_array, taken);
+		++loop->iterations;
+		zendump_loop_latch(op_array, loop, num);
+	}
+	if(other < num && taken > num) {
+		loop = zendump_loop_find(op_array, other);
+		++loop->entries;
+		zendump_loop_latch(op_array, loop, num);
+	}
+}
+
+static zval *zendump_loop_operand(zend_execute_data *execute_data, zend_uchar type, const znode_op *op)
+{
+	zval *val = zendump_operand_zval(execute_data, type, op);
+	if(val) {
+		ZVAL_DEREF(val);
+		if(Z_TYPE_P(val) == IS_UNDEF) {
+			val = &EG(uninitialized_zval);
+		}
+	}
+	return val;
+}
+
+/* Computes the outcome of a comparison whose handler takes the following
+   jump itself. Operands that could run user code, such as objects compared
+   by value or __isset(), are not evaluated and the branch is not counted. */
+static int zendump_loop_smart_branch_result(zend_execute_data *execute_data, const zend_op *opline, int *result)
+{
+	zend_op_array *op_array = &EX(func)->op_array;
+	zval *op1, *op2, *val = NULL, tmp;
+	zend_class_entry *ce;
+
+	if(opline->opcode == ZEND_ISSET_ISEMPTY_PROP_OBJ && opline->op1_type == IS_UNUSED) {
+		op1 = &EX(This);
+	} else {
+		op1 = zendump_loop_operand(execute_data, opline->op1_type, &opline->op1);
+	}
+	if(!op1) {
+		return FAILURE;
+	}
+	switch(opline->opcode) {
+		case ZEND_IS_IDENTICAL:
+		case ZEND_IS_NOT_IDENTICAL:
+			op2 = zendump_loop_operand(execute_data, opline->op2_type, &opline->op2);
+			if(!op2) {
+				return FAILURE;
+			}
+			*result = zend_is_identical(op1, op2) == (opline->opcode == ZEND_IS_IDENTICAL);
+			return SUCCESS;
+		case ZEND_IS_EQUAL:
+		case ZEND_IS_NOT_EQUAL:
+		case ZEND_IS_SMALLER:
+		case ZEND_IS_SMALLER_OR_EQUAL:
+		case ZEND_CASE:
+			op2 = zendump_loop_operand(execute_data, opline->op2_type, &opline->op2);
+			if(!op2 || Z_TYPE_P(op1) > IS_STRING || Z_TYPE_P(op2) > IS_STRING) {
+				return FAILURE;
+			}
+			if(Z_TYPE_P(op1) == IS_LONG && Z_TYPE_P(op2) == IS_LONG) {
+				ZVAL_LONG(&tmp, Z_LVAL_P(op1) < Z_LVAL_P(op2) ? -1 : (Z_LVAL_P(op1) > Z_LVAL_P(op2) ? 1 : 0));
+			} else if((Z_TYPE_P(op1) == IS_LONG || Z_TYPE_P(op1) == IS_DOUBLE) && (Z_TYPE_P(op2) == IS_LONG || Z_TYPE_P(op2) == IS_DOUBLE)) {
+				/* Compared as the handlers do, so NAN is unordered. */
+				double d1 = zval_get_double(op1), d2 = zval_get_double(op2);
+				switch(opline->opcode) {
+					case ZEND_IS_NOT_EQUAL:
+						*result = d1 != d2;
+						break;
+					case ZEND_IS_SMALLER:
+						*result = d1 < d2;
+						break;
+					case ZEND_IS_SMALLER_OR_EQUAL:
+						*result = d1 <= d2;
+						break;
+					default:
+						*result = d1 == d2;
+				}
+				return SUCCESS;
+			} else {
+				compare_function(&tmp, op1, op2);
+			}
+			switch(opline->opcode) {
+				case ZEND_IS_NOT_EQUAL:
+					*result = Z_LVAL(tmp) != 0;
+					break;
+				case ZEND_IS_SMALLER:
+					*result = Z_LVAL(tmp) < 0;
+					break;
+				case ZEND_IS_SMALLER_OR_EQUAL:
+					*result = Z_LVAL(tmp) <= 0;
+					break;
+				default:
+					*result = Z_LVAL(tmp) == 0;
+			}
+			return SUCCESS;
+		case ZEND_TYPE_CHECK:
+			if(Z_TYPE_P(op1) == opline->extended_value) {
+				if(Z_TYPE_P(op1) == IS_OBJECT) {
+					*result = !zend_string_equals_literal(Z_OBJCE_P(op1)->name, "__PHP_Incomplete_Class");
+				} else if(Z_TYPE_P(op1) == IS_RESOURCE) {
+					*result = zend_rsrc_list_get_rsrc_type(Z_RES_P(op1)) != NULL;
+				} else {
+					*result = 1;
+				}
+			} else {
+				*result = opline->extended_value == _IS_BOOL && (Z_TYPE_P(op1) == IS_FALSE || Z_TYPE_P(op1) == IS_TRUE);
+			}
+			return SUCCESS;
+		case ZEND_INSTANCEOF:
+			if(Z_TYPE_P(op1) != IS_OBJECT) {
+				*result = 0;
+				return SUCCESS;
+			}
+			if(opline->op2_type == IS_CONST) {
+				ce = zend_hash_find_ptr(EG(class_table), Z_STR_P(RT_CONSTANT(op_array, opline->op2) + 1));
+			} else if(opline->op2_type == IS_VAR) {
+				ce = Z_CE_P(EX_VAR(opline->op2.var));
+			} else {
+				return FAILURE;
+			}
+			*result = ce && instanceof_function(Z_OBJCE_P(op1), ce);
+			return SUCCESS;
+		case ZEND_ISSET_ISEMPTY_VAR:
+#ifdef ZEND_QUICK_SET
+			if(opline->op1_type != IS_CV || !(opline->extended_value & ZEND_QUICK_SET)) {
+				return FAILURE;
+			}
+			val = op1;
+			break;
+#else
+			return FAILURE;
+#endif
+		case ZEND_ISSET_ISEMPTY_DIM_OBJ:
+			op2 = zendump_loop_operand(execute_data, opline->op2_type, &opline->op2);
+			if(!op2 || Z_TYPE_P(op1) != IS_ARRAY) {
+				return FAILURE;
+			}
+			if(Z_TYPE_P(op2) == IS_STRING) {
+				val = zend_symtable_find(Z_ARRVAL_P(op1), Z_STR_P(op2));
+			} else if(Z_TYPE_P(op2) == IS_LONG) {
+				val = zend_hash_index_find(Z_ARRVAL_P(op1), Z_LVAL_P(op2));
+			} else {
+				return FAILURE;
+			}
+			if(val && Z_TYPE_P(val) == IS_INDIRECT) {
+				val = Z_INDIRECT_P(val);
+			}
+			break;
+		case ZEND_ISSET_ISEMPTY_PROP_OBJ:
+			op2 = zendump_loop_operand(execute_data, opline->op2_type, &opline->op2);
+			if(!op2) {
+				return FAILURE;
+			}
+			if(Z_TYPE_P(op1) != IS_OBJECT) {
+				*result = !(opline->extended_value & ZEND_ISSET);
+				return SUCCESS;
+			}
+			if(Z_OBJ_HT_P(op1)->has_property != zend_std_has_property || Z_OBJCE_P(op1)->__isset) {
+				return FAILURE;
+			}
+			*result = ((opline->extended_value & ZEND_ISSET) == 0) ^ zend_std_has_property(op1, op2, (opline->extended_value & ZEND_ISSET) == 0, NULL);
+			return SUCCESS;
+		default:
+			return FAILURE;
+	}
+
+	/* isset() and empty() of a variable or an array element. */
+	if(val) {
+		ZVAL_DEREF(val);
+	}
+	if(opline->extended_value & ZEND_ISSET) {
+		*result = val && Z_TYPE_P(val) > IS_NULL;
+	} else if(val && Z_TYPE_P(val) == IS_OBJECT) {
+		return FAILURE;
+	} else {
+		*result = !val || !zend_is_true(val);
+	}
+	return SUCCESS;
+}
+
+/* A loop is identified by the target of its backward jump. Taken backward
+   jumps count iterations; a conditional backward jump falling through, or
+   the FE_RESET in front of a foreach header, counts an entry of the loop.
+   The JMPZ or JMPNZ closing a loop condition usually follows a comparison
+   which takes it in its own handler, so it is observed from there. */
+void zendump_loop_profile_observe(zend_execute_data *execute_data, const zend_op *opline)
+{
+	zend_op_array *op_array = &EX(func)->op_array;
+	uint32_t num = opline - op_array->opcodes, targets[2], count, taken, other;
+	const zend_op *jump;
+	int falls_through, result;
+	zval *cond;
+
+	if(num >= op_array->last) {
+		return;
+	}
+	if(opline->opcode == ZEND_FE_RESET_R || opline->opcode == ZEND_FE_RESET_RW) {
+		if(num + 1 < op_array->last) {
+			++zendump_loop_find(op_array, num + 1)->entries;
+		}
+		return;
+	}
+
+	jump = zendump_smart_branch_jump(op_array, opline);
+	if(jump) {
+		if(zendump_loop_smart_branch_result(execute_data, opline, &result) == FAILURE ||
+			!zendump_jump_targets(op_array, (zend_op*)jump, targets, 1, &falls_through)) {
+			return;
+		}
+		if((jump->opcode == ZEND_JMPNZ) == (result != 0)) {
+			zendump_loop_branch(op_array, num + 1, targets[0], (uint32_t)-1);
+		} else {
+			zendump_loop_branch(op_array, num + 1, (uint32_t)-1, targets[0]);
+		}
+		return;
+	}
+
+	count = zendump_jump_targets(op_array, (zend_op*)opline, targets, 2, &falls_through);
+	if(!count) {
+		return;
+	}
+	taken = other = (uint32_t)-1;
+	if(opline->opcode == ZEND_JMP) {
+		taken = targets[0];
+	} else {
+		cond = zendump_operand_zval(execute_data, opline->op1_type, &opline->op1);
+		if(!cond) {
+			return;
+		}
+		switch(opline->opcode) {
+			case ZEND_JMPZ:
+			case ZEND_JMPZ_EX:
+				if(zend_is_true(cond)) {
+					other = targets[0];
+				} else {
+					taken = targets[0];
+				}
+				break;
+			case ZEND_JMPNZ:
+			case ZEND_JMPNZ_EX:
+				if(zend_is_true(cond)) {
+					taken = targets[0];
+				} else {
+					other = targets[0];
+				}
+				break;
+			case ZEND_JMPZNZ:
+				if(count < 2) {
+					return;
+				}
+				taken = zend_is_true(cond) ? targets[1] : targets[0];
+				other = zend_is_true(cond) ? targets[0] : targets[1];
+				break;
+			default:
+				return;
+		}
+	}
+	zendump_loop_branch(op_array, num, taken, other);
+}
+
+void zendump_loop_profile_startup()
+{
+	const zend_uchar opcodes[] = {
+		ZEND_JMP, ZEND_JMPZ, ZEND_JMPNZ, ZEND_JMPZNZ, ZEND_JMPZ_EX, ZEND_JMPNZ_EX, ZEND_FE_RESET_R, ZEND_FE_RESET_RW,
+		ZEND_IS_IDENTICAL, ZEND_IS_NOT_IDENTICAL, ZEND_IS_EQUAL, ZEND_IS_NOT_EQUAL, ZEND_IS_SMALLER, ZEND_IS_SMALLER_OR_EQUAL,
+		ZEND_CASE, ZEND_ISSET_ISEMPTY_VAR, ZEND_ISSET_ISEMPTY_DIM_OBJ, ZEND_ISSET_ISEMPTY_PROP_OBJ, ZEND_INSTANCEOF, ZEND_TYPE_CHECK
+	};
+	int idx;
+	for(idx = 0; idx < ARRAY_LENGTH(opcodes); ++idx) {
+		zendump_observe_opcode(opcodes[idx], zendump_loop_profile_observe);
+	}
+}
+
+typedef struct _zendump_hot_loop {
+	zendump_op_array_profile *profile;
+	zendump_loop             *loop;
+} zendump_hot_loop;
+
+static int zendump_hot_loop_compare(const void *a, const void *b)
+{
+	const zendump_loop *x = ((const zendump_hot_loop*)a)->loop;
+	const zendump_loop *y = ((const zendump_hot_loop*)b)->loop;
+	if(x->iterations != y->iterations) {
+		return x->iterations < y->iterations ? 1 : -1;
+	}
+	return 0;
+}
+
+/* The end of request report goes to stderr, so it never ends up in the
+   response body. */
+void zendump_hot_loops_dump(zend_long limit, int to_stderr)
+{
+	size_t (*print)(const char *format, ...) = to_stderr ? zendump_errorf : php_printf;
+	zendump_op_array_profile *profile;
+	zendump_hot_loop *loops = NULL;
+	zendump_loop *loop;
+	uint32_t count = 0, idx;
+
+	if(ZENDUMP_G(profiles)) {
+		ZEND_HASH_FOREACH_PTR(ZENDUMP_G(profiles), profile) {
+			if(profile->loops) {
+				count += zend_hash_num_elements(profile->loops);
+			}
+		} ZEND_HASH_FOREACH_END();
+	}
+	if(count) {
+		loops = safe_emalloc(count, sizeof(zendump_hot_loop), 0);
+		count = 0;
+		ZEND_HASH_FOREACH_PTR(ZENDUMP_G(profiles), profile) {
+			if(!profile->loops) {
+				continue;
+			}
+			ZEND_HASH_FOREACH_PTR(profile->loops, loop) {
+				if(loop->iterations) {
+					loops[count].profile = profile;
+					loops[count].loop = loop;
+					++count;
+				}
+			} ZEND_HASH_FOREACH_END();
+		} ZEND_HASH_FOREACH_END();
+		qsort(loops, count, sizeof(zendump_hot_loop), zendump_hot_loop_compare);
+	}
+	if(limit > 0 && limit < count) {
+		print("hot_loops(%u/%u): {\n", (uint32_t)limit, count);
+	} else {
+		print("hot_loops(%u): {\n", count);
+		limit = count;
+	}
+	for(idx = 0; idx < limit; ++idx) {
+		profile = loops[idx].profile;
+		loop = loops[idx].loop;
+		print("%*c%s%s%s() %s:%u-%u header(#%u) latch(#%u) iterations(%" PRIu64 ") entries(%" PRIu64 ")", INDENT_SIZE, ' ',
+			profile->scope_name ? ZSTR_VAL(profile->scope_name) : "",
+			profile->scope_name ? "::" : "",
+			profile->function_name ? ZSTR_VAL(profile->function_name) : "{main}",
+			profile->filename ? ZSTR_VAL(profile->filename) : "-",
+			loop->line_start, loop->line_end, loop->header, loop->latch, loop->iterations, loop->entries);
+		if(loop->entries) {
+			print(" average(%.2f)\n", (double)loop->iterations / loop->entries);
+		} else {
+			print(" average(-)\n");
+		}
+	}
+	print("}\n");
+	if(loops) {
+		efree(loops);
+	}
+}
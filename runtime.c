@@ -0,0 +1,200 @@
+/*
+  +----------------------------------------------------------------------+
+  | PHP Version 7                                                        |
+  +----------------------------------------------------------------------+
+  | Copyright (c) 1997-2018 The PHP Group                                |
+  +----------------------------------------------------------------------+
+  | This source file is subject to version 3.01 of the PHP license,      |
+  | that is bundled with this package in the file LICENSE, and is        |
+  | available through the world-wide-web at the following url:           |
+  | http://www.php.net/license/3_01.txt                                  |
+  | If you did not receive a copy of the PHP license and are unable to   |
+  | obtain it through the world-wide-web, please send a note to          |
+  | license@php.net so we can mail you a copy immediately.               |
+  +----------------------------------------------------------------------+
+  | Author: Youlin Feng <fengyoulin@php7th.com>                          |
+  +----------------------------------------------------------------------+
+*/
+
+/* $Id$ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "php.h"
+#include "php_ini.h"
+#include "ext/standard/info.h"
+#include "php_zendump.h"
+
+ZEND_EXTERN_MODULE_GLOBALS(zendump)
+
+typedef struct _zendump_autoload_site {
+	uint64_t count;
+	uint64_t failed;
+	uint64_t time;
+	uint64_t files;
+	uint32_t depth;
+} zendump_autoload_site;
+
+static void zendump_autoload_site_dtor(zval *zv)
+{
+	efree(Z_PTR_P(zv));
+}
+
+static void zendump_origin_execute_internal(zend_execute_data *execute_data, zval *return_value)
+{
+	if(ZENDUMP_G(origin_execute_internal)) {
+		ZENDUMP_G(origin_execute_internal)(execute_data, return_value);
+	} else {
+		execute_internal(execute_data, return_value);
+	}
+}
+
+static void zendump_autoload_record(zendump_autoload_site *site, zend_bool found, uint64_t elapsed, uint32_t files, uint32_t depth)
+{
+	++site->count;
+	if(!found) {
+		++site->failed;
+	}
+	site->time += elapsed;
+	site->files += files;
+	if(depth > site->depth) {
+		site->depth = depth;
+	}
+}
+
+/* The autoloader is an internal function (spl_autoload_call) invoked by
+   zend_lookup_class() through zend_call_function(), so it passes through
+   zend_execute_internal with the class name as its only argument. The time
+   is inclusive of nested autoloads triggered while the file is compiled. */
+static void zendump_autoload_execute_internal(zend_execute_data *execute_data, zval *return_value)
+{
+	zval *name = ZEND_CALL_NUM_ARGS(execute_data) > 0 ? ZEND_CALL_ARG(execute_data, 1) : NULL;
+	zendump_autoload_site *site;
+	zend_string *lc_name;
+	uint32_t files, depth;
+	uint64_t start, elapsed;
+	zend_bool found;
+
+	if(EX(func) != EG(autoload_func) || !name || Z_TYPE_P(name) != IS_STRING) {
+		zendump_origin_execute_internal(execute_data, return_value);
+		return;
+	}
+
+	zend_string_addref(Z_STR_P(name));
+	lc_name = zend_string_tolower(Z_STR_P(name));
+	files = zend_hash_num_elements(&EG(included_files));
+	depth = ++ZENDUMP_G(autoload_depth);
+	start = zendump_time_ns();
+
+	zendump_origin_execute_internal(execute_data, return_value);
+
+	elapsed = zendump_time_ns() - start;
+	--ZENDUMP_G(autoload_depth);
+	files = zend_hash_num_elements(&EG(included_files)) - files;
+	found = zend_hash_exists(EG(class_table), lc_name);
+
+	if(!ZENDUMP_G(autoload_sites)) {
+		ALLOC_HASHTABLE(ZENDUMP_G(autoload_sites));
+		zend_hash_init(ZENDUMP_G(autoload_sites), 32, NULL, zendump_autoload_site_dtor, 0);
+	}
+	/* Class names are case-insensitive, the sites are keyed like the class table. */
+	site = zend_hash_find_ptr(ZENDUMP_G(autoload_sites), lc_name);
+	if(!site) {
+		site = ecalloc(1, sizeof(zendump_autoload_site));
+		zend_hash_add_new_ptr(ZENDUMP_G(autoload_sites), lc_name, site);
+	}
+	zendump_autoload_record(site, found, elapsed, files, depth);
+	site = zendump_pool_record(&ZENDUMP_G(autoload_pool), ZSTR_VAL(lc_name), ZSTR_LEN(lc_name), sizeof(zendump_autoload_site), NULL);
+	zendump_autoload_record(site, found, elapsed, files, depth);
+
+	zend_string_release(lc_name);
+	zend_string_release(Z_STR_P(name));
+}
+
+void zendump_autoload_startup()
+{
+	ZENDUMP_G(origin_execute_internal) = zend_execute_internal;
+	zend_execute_internal = zendump_autoload_execute_internal;
+}
+
+void zendump_autoload_shutdown()
+{
+	if(zend_execute_internal == zendump_autoload_execute_internal) {
+		zend_execute_internal = ZENDUMP_G(origin_execute_internal);
+	}
+	zendump_pool_destroy(&ZENDUMP_G(autoload_pool));
+}
+
+typedef struct _zendump_autoload_entry {
+	zend_string           *name;
+	zendump_autoload_site *site;
+} zendump_autoload_entry;
+
+static int zendump_autoload_entry_compare(const void *a, const void *b)
+{
+	const zendump_autoload_site *x = ((const zendump_autoload_entry*)a)->site;
+	const zendump_autoload_site *y = ((const zendump_autoload_entry*)b)->site;
+	if(x->time != y->time) {
+		return x->time < y->time ? 1 : -1;
+	}
+	return 0;
+}
+
+void zendump_autoload_dump(zend_long limit, zend_bool pool)
+{
+	HashTable *sites = pool ? ZENDUMP_G(autoload_pool) : ZENDUMP_G(autoload_sites);
+	zendump_autoload_entry *entries = NULL;
+	zendump_autoload_site *site;
+	zend_string *name;
+	uint64_t time = 0, failed = 0;
+	uint32_t count = 0, idx;
+
+	if(sites) {
+		count = zend_hash_num_elements(sites);
+	}
+	if(count) {
+		entries = safe_emalloc(count, sizeof(zendump_autoload_entry), 0);
+		idx = 0;
+		ZEND_HASH_FOREACH_STR_KEY_PTR(sites, name, site) {
+			entries[idx].name = name;
+			entries[idx].site = site;
+			time += site->time;
+			failed += site->failed;
+			++idx;
+		} ZEND_HASH_FOREACH_END();
+		qsort(entries, count, sizeof(zendump_autoload_entry), zendump_autoload_entry_compare);
+	}
+	if(limit > 0 && limit < count) {
+		php_printf("%s(%u/%u", pool ? "autoload_pool" : "autoload", (uint32_t)limit, count);
+	} else {
+		php_printf("%s(%u", pool ? "autoload_pool" : "autoload", count);
+		limit = count;
+	}
+	php_printf(") time(%" PRIu64 "ns) failed(%" PRIu64 ")", time, failed);
+	if(pool) {
+		php_printf(" requests(%" PRIu64 ")", ZENDUMP_G(autoload_requests));
+	}
+	PUTS(": {\n");
+	for(idx = 0; idx < limit; ++idx) {
+		site = entries[idx].site;
+		php_printf("%*c%s count(%" PRIu64 ") failed(%" PRIu64 ") time(%" PRIu64 "ns) files(%" PRIu64 ") depth(%u)\n", INDENT_SIZE, ' ',
+			ZSTR_VAL(entries[idx].name), site->count, site->failed, site->time, site->files, site->depth);
+	}
+	PUTS("}\n");
+	if(entries) {
+		efree(entries);
+	}
+}
+
+void zendump_autoload_reset()
+{
+	if(ZENDUMP_G(autoload_sites)) {
+		zend_hash_destroy(ZENDUMP_G(autoload_sites));
+		FREE_HASHTABLE(ZENDUMP_G(autoload_sites));
+		ZENDUMP_G(autoload_sites) = NULL;
+	}
+	ZENDUMP_G(autoload_depth) = 0;
+	++ZENDUMP_G(autoload_requests);
+}
@@ -0,0 +1,28 @@
+--TEST--
+zendump_cow_report() tests
+--SKIPIF--
+<?php if (!extension_loaded("zendump")) print "skip"; ?>
+--INI--
+zendump.enable_cow_trace=1
+--FILE--
+<?php
+
+function func01() {
+	$a = [1, 2, 3];
+	$b = $a;
+	$b[] = 4;
+	$c = $b;
+	$c[0] = 0;
+	$c[1] = 1;
+}
+func01();
+zendump_cow_report();
+
+?>
+===DONE===
+--EXPECTF--
+cow(2): {
+  %s007.php:8 count(1) elements(4) bytes(%d)
+  %s007.php:6 count(1) elements(3) bytes(%d)
+}
+===DONE===
@@ -0,0 +1,44 @@
+--TEST--
+zendump_class_layout() tests
+--SKIPIF--
+<?php if (!extension_loaded("zendump")) print "skip"; ?>
+--FILE--
+<?php
+
+class SimpleClass {
+	public $a = 1;
+	protected $b = 2;
+	private $c = 3;
+	public static $d = 4;
+}
+
+$x = new SimpleClass();
+$y = new SimpleClass();
+$y->e = 5;
+zendump_class_layout('SimpleClass');
+zendump($x);
+
+?>
+===DONE===
+--EXPECTF--
+user class_layout("SimpleClass") slots(3) object_size(%d) static_members(1) static_size(16) instances(2) materialized(1) properties_size(%d) {
+  [0] offset(%d) $a
+  [1] offset(%d) $b
+  [2] offset(%d) $c
+  static [0] $d
+}
+zval(0x%x) -> object(SimpleClass) addr(0x%x) refcount(%d) {
+  default_properties(3) {
+    $a =>
+    zval(0x%x) : long(1)
+    $b =>
+    zval(0x%x) : long(2)
+    $c =>
+    zval(0x%x) : long(3)
+  }
+  static_members(1) {
+    $d =>
+    zval(0x%x) : long(4)
+  }
+}
+===DONE===
@@ -0,0 +1,29 @@
+--TEST--
+zendump_objects_survey() tests
+--SKIPIF--
+<?php if (!extension_loaded("zendump")) print "skip"; ?>
+--INI--
+zendump.enable_properties_trace=1
+--FILE--
+<?php
+
+class SimpleClass {
+	public $a = 1;
+}
+
+$x = new SimpleClass();
+$y = new SimpleClass();
+$z = new SimpleClass();
+$y->b = 2;
+$v = get_object_vars($z);
+zendump_objects_survey();
+
+?>
+===DONE===
+--EXPECTF--
+objects(1): {
+  "SimpleClass" instances(3) materialized(2) bytes(%d)
+    %s009.php:10 ASSIGN_OBJ count(1)
+    %s009.php:11 DO_ICALL count(1)
+}
+===DONE===
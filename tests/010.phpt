@@ -0,0 +1,27 @@
+--TEST--
+zendump_string_audit() tests
+--SKIPIF--
+<?php if (!extension_loaded("zendump")) print "skip"; ?>
+--INI--
+variables_order=GPC
+--FILE--
+<?php
+
+$a = str_repeat('x', 20);
+$b = str_repeat('x', 20);
+$c = [str_repeat('y', 10), str_repeat('y', 10), 'k' => str_repeat('y', 10)];
+$n = count($GLOBALS);
+zendump_string_audit(2);
+
+?>
+===DONE===
+--EXPECTF--
+strings(2) wasted(%d): {
+  string(10,"yyyyyyyyyy") copies(3) wasted(%d)
+    $c[0]
+    $c[1]
+  string(20,"xxxxxxxxxxxxxxxxxxxx") copies(2) wasted(%d)
+    $a
+    $b
+}
+===DONE===
@@ -0,0 +1,29 @@
+--TEST--
+zendump_immutable_audit() tests
+--SKIPIF--
+<?php if (!extension_loaded("zendump")) print "skip"; ?>
+<?php if (function_exists("opcache_get_status") && @opcache_get_status()) print "skip opcache makes literal arrays immutable"; ?>
+--INI--
+zendump.enable_immutable_trace=1
+--FILE--
+<?php
+
+function func01() {
+	$a = [1, 2, 3, 4, 5, 6, 7, 8, 9, 10];
+	return $a;
+}
+class SimpleClass {
+	const ITEMS = [1, 2, 3, 4, 5, 6, 7, 8];
+}
+func01();
+func01();
+zendump_immutable_audit();
+
+?>
+===DONE===
+--EXPECTF--
+immutable_audit: {
+  op_array("func01") literal(%d) array(10) bytes(%d) copies(2) %s011.php:4
+  class_constant("SimpleClass::ITEMS") array(8) bytes(%d) %s011.php:7
+} flagged(2)
+===DONE===
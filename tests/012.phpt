@@ -0,0 +1,36 @@
+--TEST--
+zendump.enable_opcode_profile tests
+--SKIPIF--
+<?php if (!extension_loaded("zendump")) print "skip"; ?>
+--INI--
+zendump.enable_opcode_profile=1
+--FILE--
+<?php
+
+function func01($n) {
+	$s = 0;
+	for($i = 0; $i < $n; ++$i) {
+		$s += $i;
+	}
+	return $s;
+}
+func01(3);
+zendump_function('func01', 20);
+zendump_opcode_mix(1);
+
+?>
+===DONE===
+--EXPECTF--
+op_array("func01")%sline(3,9)
+HITS        OPCODE%s
+1           RECV%s
+%A
+3           ASSIGN_ADD%s
+%A
+4           IS_SMALLER%s
+4           JMPNZ%s
+%A
+opcode_mix(%d) total(%d): {
+  %s
+}
+===DONE===
@@ -0,0 +1,33 @@
+--TEST--
+zendump_line_profile() tests
+--SKIPIF--
+<?php if (!extension_loaded("zendump")) print "skip"; ?>
+--INI--
+zendump.enable_line_profile=1
+--FILE--
+<?php
+
+function func01($n) {
+	$s = 0;
+	for($i = 0; $i < $n; ++$i) {
+		$s += $i;
+	}
+	return $s;
+}
+func01(3);
+$profile = zendump_line_profile(__DIR__ . '/013.callgrind');
+var_dump($profile[__FILE__][6][0], $profile[__FILE__][6][1] >= 0);
+$callgrind = file(__DIR__ . '/013.callgrind', FILE_IGNORE_NEW_LINES);
+var_dump($callgrind[3], in_array('fn=func01', $callgrind), in_array('6 3 ' . $profile[__FILE__][6][1], $callgrind));
+
+?>
+===DONE===
+--CLEAN--
+<?php @unlink(__DIR__ . '/013.callgrind'); ?>
+--EXPECT--
+int(3)
+bool(true)
+string(24) "events: Hits Nanoseconds"
+bool(true)
+bool(true)
+===DONE===
@@ -0,0 +1,68 @@
+--TEST--
+zendump_cfg() tests
+--SKIPIF--
+<?php if (!extension_loaded("zendump") || !extension_loaded("json")) print "skip"; ?>
+--FILE--
+<?php
+
+function func01($a) {
+	if($a) {
+		return 1;
+	}
+	return 2;
+}
+class Class01 {
+	public function func02() {
+		try {
+			func01(1);
+		} catch(Exception $e) {
+			return 0;
+		}
+		return 1;
+	}
+}
+$cfg = json_decode(zendump_cfg('func01', 'json'), true);
+var_dump($cfg['function'], count($cfg['blocks']), $cfg['blocks'][0]['opcodes'], $cfg['edges']);
+$cfg = json_decode(zendump_cfg('Class01::func02', 'json'), true);
+var_dump(in_array('exception', array_column($cfg['edges'], 'type')));
+var_dump(strpos(zendump_cfg('func01'), 'digraph "func01" {'));
+var_dump(zendump_cfg('func01', 'xml'), zendump_cfg('strlen'));
+
+?>
+===DONE===
+--EXPECTF--
+string(6) "func01"
+int(4)
+array(2) {
+  [0]=>
+  string(4) "RECV"
+  [1]=>
+  string(4) "JMPZ"
+}
+array(2) {
+  [0]=>
+  array(3) {
+    ["from"]=>
+    int(0)
+    ["to"]=>
+    int(2)
+    ["type"]=>
+    string(4) "jump"
+  }
+  [1]=>
+  array(3) {
+    ["from"]=>
+    int(0)
+    ["to"]=>
+    int(1)
+    ["type"]=>
+    string(11) "fallthrough"
+  }
+}
+bool(true)
+int(0)
+
+Warning: zendump_cfg(): Unknown format 'xml', expecting 'dot' or 'json' in %s on line %d
+bool(false)
+bool(false)
+===DONE===
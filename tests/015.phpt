@@ -0,0 +1,49 @@
+--TEST--
+zendump_hot_loops() tests
+--SKIPIF--
+<?php if (!extension_loaded("zendump")) print "skip"; ?>
+--INI--
+zendump.enable_loop_profile=1
+--FILE--
+<?php
+
+function func01($n) {
+	$s = 0;
+	for($i = 0; $i < $n; ++$i) {
+		$s += $i;
+	}
+	return $s;
+}
+function func02($arr) {
+	$s = 0;
+	foreach($arr as $v) {
+		$s += $v;
+	}
+	return $s;
+}
+function func03() {
+	$s = '';
+	for($i = 0; $i < 5; $i++) {
+		$s .= $i;
+	}
+	return $s;
+}
+func01(10);
+func01(20);
+func02([1, 2, 3]);
+func03();
+zendump_hot_loops();
+zendump_hot_loops(1);
+
+?>
+===DONE===
+--EXPECTF--
+hot_loops(3): {
+  func01() %s015.php:%d-%d header(#%d) latch(#%d) iterations(30) entries(2) average(15.00)
+  func03() %s015.php:%d-%d header(#%d) latch(#%d) iterations(5) entries(1) average(5.00)
+  func02() %s015.php:%d-%d header(#%d) latch(#%d) iterations(3) entries(1) average(3.00)
+}
+hot_loops(1/3): {
+  func01() %s015.php:%d-%d header(#%d) latch(#%d) iterations(30) entries(2) average(15.00)
+}
+===DONE===
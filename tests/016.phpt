@@ -0,0 +1,37 @@
+--TEST--
+zendump_coverage_start() and zendump_coverage_stop() tests
+--SKIPIF--
+<?php if (!extension_loaded("zendump")) print "skip"; ?>
+--INI--
+zendump.enable_coverage=1
+--FILE--
+<?php
+function func01($a) {
+	if($a) {
+		return 1;
+	}
+	return 2;
+}
+function func02() {
+	return 3;
+}
+var_dump(zendump_coverage_start());
+func01(1);
+$coverage = zendump_coverage_stop();
+var_dump($coverage[__FILE__][3], $coverage[__FILE__][4], $coverage[__FILE__][6], $coverage[__FILE__][9], isset($coverage[__FILE__][5]));
+zendump_coverage_start();
+func01(0);
+$coverage = zendump_coverage_stop();
+var_dump($coverage[__FILE__][4], $coverage[__FILE__][6]);
+?>
+===DONE===
+--EXPECT--
+bool(true)
+int(1)
+int(1)
+int(-1)
+int(-1)
+bool(false)
+int(-1)
+int(1)
+===DONE===
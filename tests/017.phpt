@@ -0,0 +1,43 @@
+--TEST--
+zendump_codebase_stats() tests
+--SKIPIF--
+<?php if (!extension_loaded("zendump")) print "skip"; ?>
+--FILE--
+<?php
+function func01() {
+	static $count = 0;
+	return ++$count;
+}
+class Class01 {
+	public function func02($a, $b) {
+		return [$a, $b, 'abc'];
+	}
+}
+zendump_codebase_stats(1);
+?>
+===DONE===
+--EXPECTF--
+codebase functions(2) classes(1): {
+  opcodes(%d): {
+    %d%wClass01::func02() %s017.php:7
+  }
+  vars(%d): {
+    2           Class01::func02() %s017.php:7
+  }
+  T(%d): {
+    %d%w%s() %s017.php:%d
+  }
+  literals(%d): {
+    %d%w%s() %s017.php:%d
+  }
+  literal_bytes(%d): {
+    %d%w%s() %s017.php:%d
+  }
+  static_vars(1): {
+    1           func01() %s017.php:2
+  }
+  opcode_mix(%d): {
+%A
+  }
+}
+===DONE===
@@ -0,0 +1,30 @@
+--TEST--
+zendump_compile_profile() tests
+--SKIPIF--
+<?php if (!extension_loaded("zendump")) print "skip"; ?>
+--INI--
+zendump.enable_compile_profile=1
+--FILE--
+<?php
+file_put_contents(__DIR__ . '/018.inc', '<?php
+function func01() { return 1; }
+class Class01 { public function func02() { return 2; } }
+');
+include __DIR__ . '/018.inc';
+eval('$a = 1;');
+zendump_compile_profile();
+zendump_compile_profile(1);
+?>
+===DONE===
+--CLEAN--
+<?php @unlink(__DIR__ . '/018.inc'); ?>
+--EXPECTF--
+compile(3) time(%dns): {
+  %s %s count(1) time(%dns) memory(%d) op_arrays(%d) classes(%d) opcodes(%d)
+  %s %s count(1) time(%dns) memory(%d) op_arrays(%d) classes(%d) opcodes(%d)
+  %s %s count(1) time(%dns) memory(%d) op_arrays(%d) classes(%d) opcodes(%d)
+}
+compile(1/3) time(%dns): {
+  %s %s count(1) time(%dns) memory(%d) op_arrays(%d) classes(%d) opcodes(%d)
+}
+===DONE===
@@ -0,0 +1,37 @@
+--TEST--
+zendump_autoload_profile() tests
+--SKIPIF--
+<?php if (!extension_loaded("zendump") || !extension_loaded("spl")) print "skip"; ?>
+--INI--
+zendump.enable_autoload_trace=1
+--FILE--
+<?php
+file_put_contents(__DIR__ . '/019.inc', '<?php class Class02 extends Class03 {}');
+spl_autoload_register(function($name) {
+	if($name === 'Class02') {
+		include __DIR__ . '/019.inc';
+	} elseif($name === 'Class03') {
+		eval('class Class03 {}');
+	}
+});
+new Class02();
+var_dump(class_exists('Class01'));
+var_dump(class_exists('CLASS01'));
+zendump_autoload_profile();
+zendump_autoload_profile(1, true);
+?>
+===DONE===
+--CLEAN--
+<?php @unlink(__DIR__ . '/019.inc'); ?>
+--EXPECTF--
+bool(false)
+bool(false)
+autoload(3) time(%dns) failed(2): {
+  %s count(%d) failed(%d) time(%dns) files(%d) depth(%d)
+  %s count(%d) failed(%d) time(%dns) files(%d) depth(%d)
+  %s count(%d) failed(%d) time(%dns) files(%d) depth(%d)
+}
+autoload_pool(1/3) time(%dns) failed(2) requests(0): {
+  class02 count(1) failed(0) time(%dns) files(1) depth(1)
+}
+===DONE===
@@ -0,0 +1,31 @@
+--TEST--
+zendump_preload_script() tests
+--SKIPIF--
+<?php if (!extension_loaded("zendump")) print "skip"; ?>
+--INI--
+zendump.enable_preload_trace=1
+--FILE--
+<?php
+file_put_contents(__DIR__ . '/020.base.inc', '<?php class Class01 {}');
+file_put_contents(__DIR__ . '/020.child.inc', '<?php function func01() {} class Class02 extends Class01 {}');
+include __DIR__ . '/020.base.inc';
+include __DIR__ . '/020.child.inc';
+var_dump(zendump_preload_script(__DIR__ . '/020.preload'));
+$lines = file(__DIR__ . '/020.preload', FILE_IGNORE_NEW_LINES);
+var_dump(count($lines), $lines[0]);
+echo basename($lines[2]), "\n", basename($lines[3]), "\n";
+?>
+===DONE===
+--CLEAN--
+<?php
+@unlink(__DIR__ . '/020.base.inc');
+@unlink(__DIR__ . '/020.child.inc');
+@unlink(__DIR__ . '/020.preload');
+?>
+--EXPECT--
+int(2)
+int(4)
+string(5) "<?php"
+020.base.inc');
+020.child.inc');
+===DONE===
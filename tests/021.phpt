@@ -0,0 +1,33 @@
+--TEST--
+zendump_runtime_cache() tests
+--SKIPIF--
+<?php if (!extension_loaded("zendump")) print "skip"; ?>
+--INI--
+zendump.enable_cache_profile=1
+--FILE--
+<?php
+class Class01 {
+	public $x = 1;
+}
+class Class02 {
+	public $y = 0;
+	public $x = 2;
+}
+function func01($o) {
+	return $o->x;
+}
+zendump_runtime_cache('func01');
+func01(new Class01());
+func01(new Class02());
+func01(new Class02());
+zendump_runtime_cache('func01');
+?>
+===DONE===
+--EXPECTF--
+runtime_cache(func01) size(%d) slots(1) populated(0): {
+  #1 FETCH_OBJ_R line(10) op2 slot(%d) empty
+}
+runtime_cache(func01) size(%d) slots(1) populated(1): {
+  #1 FETCH_OBJ_R line(10) op2 slot(%d) class(Class02) offset(%d) hits(1) misses(1) cold(1)
+}
+===DONE===
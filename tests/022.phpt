@@ -0,0 +1,46 @@
+--TEST--
+zendump_receiver_profile() tests
+--SKIPIF--
+<?php if (!extension_loaded("zendump")) print "skip"; ?>
+--INI--
+zendump.enable_receiver_profile=1
+--FILE--
+<?php
+interface Speaker {
+	public function speak($loud = false);
+}
+class Dog implements Speaker {
+	public static function create() { return new Dog(); }
+	public function speak($loud = false) { return 'woof'; }
+}
+class Cat implements Speaker {
+	public function speak($loud = false) { return 'meow'; }
+}
+function func01(Speaker $s) {
+	return $s->speak();
+}
+for($i = 0; $i < 2; ++$i) {
+	func01(Dog::create());
+}
+func01(new Cat());
+zendump_receiver_profile(0, 2);
+zendump_receiver_profile();
+?>
+===DONE===
+--EXPECTF--
+receivers(1): {
+  %s022.php:13 #%d speak($loud) total(3) classes(2): {
+    Dog 2 66.67%
+    Cat 1 33.33%
+  }
+}
+receivers(2): {
+  %s022.php:13 #%d speak($loud) total(3) classes(2): {
+    Dog 2 66.67%
+    Cat 1 33.33%
+  }
+  %s022.php:16 #%d create() total(2) classes(1): {
+    Dog 2 100.00%
+  }
+}
+===DONE===
@@ -0,0 +1,49 @@
+--TEST--
+zendump_type_profile() tests
+--SKIPIF--
+<?php if (!extension_loaded("zendump")) print "skip"; ?>
+--INI--
+zendump.enable_type_profile=1
+--FILE--
+<?php
+class Class01 {}
+function func01($a, $b, $c = null) {
+	return $c ? new Class01() : null;
+}
+function gen01($n) {
+	for($i = 0; $i < 3; ++$i) {
+		yield $i;
+		$n = (string)$n;
+	}
+}
+func01(1, 'a');
+func01(2, 3, true);
+foreach(gen01(3) as $v) {
+}
+zendump_type_profile();
+zendump_type_profile(0, true);
+?>
+===DONE===
+--EXPECTF--
+types: {
+  func01() %s023.php: {
+    $a int samples(2) monomorphic
+    $b int|string samples(2) polymorphic
+    $c bool samples(1) monomorphic
+    return ?Class01 samples(2) monomorphic
+  }
+  gen01() %s023.php: {
+    $n int samples(1) monomorphic
+  }
+}
+types: {
+  func01() %s023.php: {
+    $a int samples(2) monomorphic
+    $c bool samples(1) monomorphic
+    return ?Class01 samples(2) monomorphic
+  }
+  gen01() %s023.php: {
+    $n int samples(1) monomorphic
+  }
+}
+===DONE===
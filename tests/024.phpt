@@ -0,0 +1,46 @@
+--TEST--
+zendump_optimizer_diff() tests
+--SKIPIF--
+<?php
+if (!extension_loaded("zendump")) print "skip";
+if (!extension_loaded("Zend OPcache") || !ini_get("opcache.enable_cli")) print "skip opcache is not enabled";
+?>
+--INI--
+opcache.enable=1
+opcache.enable_cli=1
+opcache.file_update_protection=0
+--FILE--
+<?php
+file_put_contents(__DIR__ . '/024.inc', '<?php
+function func01() {
+	$a = 1 + 2;
+	return $a;
+}
+class Class01 {
+	public function func02() {
+		return func01();
+	}
+}
+class Class02 extends Class03 {
+	public function func03() {
+		return 1;
+	}
+}
+');
+var_dump(zendump_optimizer_diff(__DIR__ . '/024.inc'));
+var_dump(function_exists('func01'), class_exists('Class01', false));
+?>
+===DONE===
+--CLEAN--
+<?php @unlink(__DIR__ . '/024.inc'); ?>
+--EXPECTF--
+optimizer_diff(%s024.inc) level(0x%s): {
+  {main}() opcodes(%d/%d) T(%d/%d) literals(%d/%d)%A
+  func01() opcodes(%d/%d) T(%d/%d) literals(%d/%d)%A
+  Class01::func02() opcodes(%d/%d) T(%d/%d) literals(%d/%d)%A
+  Class02::func03() opcodes(%d/%d) T(%d/%d) literals(%d/%d)%A
+}
+bool(true)
+bool(false)
+bool(false)
+===DONE===
@@ -0,0 +1,63 @@
+--TEST--
+zendump_file() tests
+--SKIPIF--
+<?php if (!extension_loaded("zendump")) print "skip"; ?>
+--FILE--
+<?php
+$dir = __DIR__ . '/025.dir';
+@mkdir($dir . '/sub', 0777, true);
+file_put_contents($dir . '/a.php', '<?php
+function func01($a) {
+	return $a + 1;
+}
+');
+file_put_contents($dir . '/sub/b.php', '<?php
+class Class01 {
+	public function func02() {
+		return 2;
+	}
+}
+');
+file_put_contents($dir . '/sub/c.php', '<?php func03(');
+file_put_contents($dir . '/sub/d.php', '<?php class Exception {}');
+file_put_contents($dir . '/notes.txt', 'skipped');
+
+var_dump(zendump_file($dir . '/a.php'));
+var_dump(function_exists('func01'));
+require_once $dir . '/a.php';
+var_dump(function_exists('func01'));
+
+var_dump(zendump_file($dir, __DIR__ . '/025.out'));
+$out = file_get_contents(__DIR__ . '/025.out');
+preg_match('/index_offset\((\d+)\)\n$/', $out, $m);
+echo substr($out, $m[1]);
+?>
+===DONE===
+--CLEAN--
+<?php
+$dir = __DIR__ . '/025.dir';
+@unlink($dir . '/a.php');
+@unlink($dir . '/sub/b.php');
+@unlink($dir . '/sub/c.php');
+@unlink($dir . '/sub/d.php');
+@unlink($dir . '/notes.txt');
+@rmdir($dir . '/sub');
+@rmdir($dir);
+@unlink(__DIR__ . '/025.out');
+?>
+--EXPECTF--
+file("%s025.dir/a.php")
+op_array("")%A
+op_array("func01") func01($a)%A
+bool(true)
+bool(false)
+bool(true)
+int(2)
+index(2/4): {
+  0 %s025.dir/a.php
+  %d %s025.dir/sub/b.php
+  failed %s025.dir/sub/c.php
+  failed %s025.dir/sub/d.php
+}
+index_offset(%d)
+===DONE===
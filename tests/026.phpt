@@ -0,0 +1,35 @@
+--TEST--
+zendump_gc_profile() tests
+--SKIPIF--
+<?php if (!extension_loaded("zendump")) print "skip"; ?>
+--INI--
+zendump.enable_gc_profile=1
+zend.enable_gc=1
+--FILE--
+<?php
+class Node {
+	public $next;
+}
+function func01() {
+	for($i = 0; $i < 10; ++$i) {
+		$a = new Node();
+		$b = new Node();
+		$a->next = $b;
+		$b->next = $a;
+	}
+}
+func01();
+$keep = new Node();
+var_dump(gc_collect_cycles() > 0);
+zendump_gc_profile();
+?>
+===DONE===
+--EXPECTF--
+bool(true)
+gc(1) time(%dns) max(%dns) collected(%d): {
+  gc_collect_cycles roots(%d) collected(%d) time(%dns)
+}
+garbage(1): {
+  Node count(20)
+}
+===DONE===
@@ -0,0 +1,65 @@
+--TEST--
+zendump_error_profile() tests
+--SKIPIF--
+<?php if (!extension_loaded("zendump")) print "skip"; ?>
+--INI--
+zendump.enable_error_trace=1
+error_reporting=E_ALL
+display_errors=0
+--FILE--
+<?php
+class Exception01 extends RuntimeException {}
+function func01($i) {
+	if($i % 2) {
+		throw new Exception01('odd');
+	}
+	return new LogicException('even');
+}
+for($i = 0; $i < 4; ++$i) {
+	try {
+		func01($i);
+	} catch(Exception01 $e) {
+	}
+}
+for($i = 0; $i < 3; ++$i) {
+	$a = @$undefined;
+}
+function func02($a) {
+	throw new Exception('call_user_func');
+}
+try {
+	array_map(function($a) { throw new Exception('array_map'); }, [1]);
+} catch(Exception $e) {
+	echo $e->getMessage(), "\n";
+}
+try {
+	$list = [2, 1];
+	usort($list, function($a, $b) { throw new Exception('usort'); });
+} catch(Exception $e) {
+	echo $e->getMessage(), "\n";
+}
+try {
+	call_user_func('func02', 1);
+} catch(Exception $e) {
+	echo $e->getMessage(), "\n";
+}
+zendump_error_profile();
+zendump_error_profile(1, true);
+?>
+===DONE===
+--EXPECTF--
+array_map
+usort
+call_user_func
+errors(6) count(10) thrown(5) time(%dns): {
+  %s %s027.php:%d count(%d) thrown(%d) suppressed(%d) time(%dns)
+  %s %s027.php:%d count(%d) thrown(%d) suppressed(%d) time(%dns)
+  %s %s027.php:%d count(%d) thrown(%d) suppressed(%d) time(%dns)
+  %s %s027.php:%d count(%d) thrown(%d) suppressed(%d) time(%dns)
+  %s %s027.php:%d count(%d) thrown(%d) suppressed(%d) time(%dns)
+  %s %s027.php:%d count(%d) thrown(%d) suppressed(%d) time(%dns)
+}
+errors_pool(1/6) count(10) thrown(5) time(%dns) requests(0): {
+  %s %s027.php:%d count(%d) thrown(%d) suppressed(%d) time(%dns)
+}
+===DONE===
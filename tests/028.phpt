@@ -0,0 +1,43 @@
+--TEST--
+zendump.watchdog_threshold tests
+--SKIPIF--
+<?php
+if (!extension_loaded("zendump")) print "skip";
+if (PHP_ZTS || PHP_VERSION_ID < 70100 || PHP_OS != 'Linux') print "skip needs a non-ZTS build of PHP 7.1+ on Linux";
+?>
+--INI--
+zendump.watchdog_threshold=50
+zendump.watchdog_log={PWD}/028.log
+--FILE--
+<?php
+class Class01 {
+	public function func01($n, $s) {
+		$end = microtime(true) + 0.3;
+		$list = [1, 2, 3];
+		while(microtime(true) < $end) {
+		}
+		return $n;
+	}
+}
+function func02() {
+	$obj = new Class01();
+	return $obj->func01(7, str_repeat('x', 100));
+}
+func02();
+echo file_get_contents(__DIR__ . '/028.log');
+?>
+===DONE===
+--CLEAN--
+<?php @unlink(__DIR__ . '/028.log'); ?>
+--EXPECTF--
+watchdog pid(%d) elapsed(%dms) script(%s) uri(%s): {
+  #0 Class01::func01() %s028.php:%d
+    $n = long(7)
+    $s = string(100,"xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx...")
+    $end = double(%f)
+    $list = array(3)
+  #1 func02() %s028.php:13
+    $obj = object(Class01)#%d
+  #2 {main}() %s028.php:15
+}
+===DONE===
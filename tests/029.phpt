@@ -0,0 +1,42 @@
+--TEST--
+zendump_backtrace_capture() and zendump_backtrace_format() tests
+--SKIPIF--
+<?php if (!extension_loaded("zendump")) print "skip"; ?>
+--FILE--
+<?php
+class Class01 {
+	public function func01($a, $b) {
+		return zendump_backtrace_capture(0, true);
+	}
+	public static function func02() {
+		return zendump_backtrace_capture(1);
+	}
+}
+function func03($n) {
+	$obj = new Class01();
+	return $obj->func01($n, 'abc');
+}
+$closure = function() {
+	return func03(5);
+};
+$h1 = $closure();
+$h2 = Class01::func02();
+unset($closure);
+var_dump($h1, $h2);
+echo zendump_backtrace_format($h1);
+echo zendump_backtrace_format($h2);
+var_dump(zendump_backtrace_format(5));
+?>
+===DONE===
+--EXPECTF--
+int(0)
+int(1)
+#0 Class01->func01(long(5), string(3,"abc")) %s029.php:4
+#1 func03(long(5)) %s029.php:12
+#2 {closure}() %s029.php:15
+#3 {main}() %s029.php:17
+#0 Class01::func02() %s029.php:7
+
+Warning: zendump_backtrace_format(): Invalid backtrace handle 5 in %s on line %d
+bool(false)
+===DONE===
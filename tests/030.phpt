@@ -0,0 +1,67 @@
+--TEST--
+zendump_diff() tests
+--SKIPIF--
+<?php if (!extension_loaded("zendump")) print "skip"; ?>
+--FILE--
+<?php
+class Class01 {
+	public $name;
+	protected $parent;
+	private $list = [];
+	public function __construct($name, $parent = null) {
+		$this->name = $name;
+		$this->parent = $parent;
+	}
+	public function add($item) {
+		$this->list[] = $item;
+	}
+}
+$shared = range(1, 1000);
+$a = ['shared' => $shared, 'n' => 1, 'gone' => true, 'obj' => new Class01('x')];
+$b = $a;
+$b['n'] = 2;
+unset($b['gone']);
+$b['new'] = 'value';
+$b['obj'] = new Class01('y', $b['obj']);
+$b['obj']->add(1.5);
+var_dump(zendump_diff($a, $b));
+
+$root1 = new Class01('root');
+$root1->add($root1);
+$root2 = new Class01('root');
+$root2->add($root2);
+var_dump(zendump_diff($root1, $root2));
+var_dump(zendump_diff($a, $b, 1));
+
+$r1 = [];
+$r1[0] = &$r1;
+$r1[1] = &$r1;
+$r2 = [];
+$r2[0] = &$r2;
+$r2[1] = &$r2;
+var_dump(zendump_diff($r1, $r2));
+?>
+===DONE===
+--EXPECTF--
+diff(6): {
+  $["n"]: long(1) => long(2)
+  $["gone"]: removed true
+  $["obj"]->name: string(1,"x") => string(1,"y")
+  $["obj"]->parent: null => object(Class01)#%d
+  $["obj"]->list[0]: added double(1.5)
+  $["new"]: added string(5,"value")
+}
+int(6)
+diff(0): {
+}
+int(0)
+diff(1+): {
+  $["n"]: long(1) => long(2)
+}
+int(1)
+diff(2): {
+  $[0]: recursive
+  $[1]: recursive
+}
+int(2)
+===DONE===
@@ -29,7 +29,7 @@
 
 ZEND_DECLARE_MODULE_GLOBALS(zendump)
 
-void zendump_execute(zend_execute_data *ex)
+static void zendump_trace_call(zend_execute_data *ex)
 {
     if(ex && ex->func && ex->func->common.function_name)
     {
@@ -48,8 +48,161 @@ void zendump_execute(zend_execute_data *ex)
             zendump_errorf("%s\n", ZSTR_VAL(name));
         }
     }
+}
+
+void zendump_execute(zend_execute_data *ex)
+{
+    if(ZENDUMP_G(enable_trace))
+    {
+        zendump_trace_call(ex);
+    }
+    if(ZENDUMP_G(enable_type_profile) && ex && ex->func)
+    {
+        zendump_type_profile_enter(ex);
+    }
     if(ZENDUMP_G(origin_execute))
     {
         ZENDUMP_G(origin_execute)(ex);
     }
 }
+
+static user_opcode_handler_t zendump_origin_opcode_handlers[256];
+static zendump_opcode_observer zendump_opcode_observers[32];
+static uint32_t zendump_opcode_observer_masks[256];
+static int zendump_opcode_observer_count = 0;
+
+static int zendump_opcode_handler(zend_execute_data *execute_data)
+{
+    const zend_op *opline = EX(opline);
+    uint32_t mask = zendump_opcode_observer_masks[opline->opcode];
+    int idx;
+    for(idx = 0; mask; ++idx, mask >>= 1)
+    {
+        if(mask & 1)
+        {
+            zendump_opcode_observers[idx](execute_data, opline);
+        }
+    }
+    if(zendump_origin_opcode_handlers[opline->opcode])
+    {
+        return zendump_origin_opcode_handlers[opline->opcode](execute_data);
+    }
+    return ZEND_USER_OPCODE_DISPATCH;
+}
+
+int zendump_observe_opcode(zend_uchar opcode, zendump_opcode_observer observer)
+{
+    int idx;
+    for(idx = 0; idx < zendump_opcode_observer_count; ++idx)
+    {
+        if(zendump_opcode_observers[idx] == observer)
+        {
+            break;
+        }
+    }
+    if(idx == zendump_opcode_observer_count)
+    {
+        if(idx == ARRAY_LENGTH(zendump_opcode_observers))
+        {
+            return FAILURE;
+        }
+        zendump_opcode_observers[zendump_opcode_observer_count++] = observer;
+    }
+    if(!zendump_opcode_observer_masks[opcode])
+    {
+        user_opcode_handler_t origin = zend_get_user_opcode_handler(opcode);
+        if(zend_set_user_opcode_handler(opcode, zendump_opcode_handler) == FAILURE)
+        {
+            return FAILURE;
+        }
+        zendump_origin_opcode_handlers[opcode] = origin;
+    }
+    zendump_opcode_observer_masks[opcode] |= (1U << idx);
+    return SUCCESS;
+}
+
+int zendump_observe_all_opcodes(zendump_opcode_observer observer)
+{
+    int idx;
+    for(idx = 0; idx <= ZEND_VM_LAST_OPCODE; ++idx)
+    {
+        if(idx == ZEND_HANDLE_EXCEPTION || idx == ZEND_USER_OPCODE)
+        {
+            continue;
+        }
+        if(zendump_observe_opcode((zend_uchar)idx, observer) == FAILURE)
+        {
+            return FAILURE;
+        }
+    }
+    return SUCCESS;
+}
+
+void zendump_unobserve_opcodes()
+{
+    int idx;
+    for(idx = 0; idx < ARRAY_LENGTH(zendump_opcode_observer_masks); ++idx)
+    {
+        if(zendump_opcode_observer_masks[idx])
+        {
+            zend_set_user_opcode_handler((zend_uchar)idx, zendump_origin_opcode_handlers[idx]);
+            zendump_origin_opcode_handlers[idx] = NULL;
+            zendump_opcode_observer_masks[idx] = 0;
+        }
+    }
+    zendump_opcode_observer_count = 0;
+}
+
+/* On PHP 7.0 - 7.2 these opcodes take a JMPZ or JMPNZ that follows them
+   themselves, so the handler of that jump never runs. Returns the jump. */
+const zend_op *zendump_smart_branch_jump(zend_op_array *op_array, const zend_op *opline)
+{
+    switch(opline->opcode)
+    {
+        case ZEND_IS_IDENTICAL:
+        case ZEND_IS_NOT_IDENTICAL:
+        case ZEND_IS_EQUAL:
+        case ZEND_IS_NOT_EQUAL:
+        case ZEND_IS_SMALLER:
+        case ZEND_IS_SMALLER_OR_EQUAL:
+        case ZEND_CASE:
+        case ZEND_ISSET_ISEMPTY_VAR:
+        case ZEND_ISSET_ISEMPTY_DIM_OBJ:
+        case ZEND_ISSET_ISEMPTY_PROP_OBJ:
+        case ZEND_INSTANCEOF:
+        case ZEND_TYPE_CHECK:
+            if((uint32_t)(opline - op_array->opcodes) + 1 < op_array->last && (opline[1].opcode == ZEND_JMPZ || opline[1].opcode == ZEND_JMPNZ))
+            {
+                return opline + 1;
+            }
+            break;
+    }
+    return NULL;
+}
+
+zval *zendump_operand_zval(zend_execute_data *execute_data, zend_uchar type, const znode_op *op)
+{
+    zval *val = NULL;
+    switch(type)
+    {
+        case IS_CONST:
+#if SIZEOF_SIZE_T == 8
+            val = (zval*)((char*)EX(func)->op_array.literals + op->constant);
+#elif SIZEOF_SIZE_T == 4
+            val = op->zv;
+#else
+# error "Unknown SIZEOF_SIZE_T"
+#endif
+            break;
+        case IS_CV:
+        case IS_TMP_VAR:
+        case IS_VAR:
+            val = ZEND_CALL_VAR(execute_data, op->var);
+            if(Z_TYPE_P(val) == IS_INDIRECT)
+            {
+                val = Z_INDIRECT_P(val);
+            }
+            break;
+    }
+    return val;
+}
@@ -0,0 +1,297 @@
+/*
+  +----------------------------------------------------------------------+
+  | PHP Version 7                                                        |
+  +----------------------------------------------------------------------+
+  | Copyright (c) 1997-2018 The PHP Group                                |
+  +----------------------------------------------------------------------+
+  | This source file is subject to version 3.01 of the PHP license,      |
+  | that is bundled with this package in the file LICENSE, and is        |
+  | available through the world-wide-web at the following url:           |
+  | http://www.php.net/license/3_01.txt                                  |
+  | If you did not receive a copy of the PHP license and are unable to   |
+  | obtain it through the world-wide-web, please send a note to          |
+  | license@php.net so we can mail you a copy immediately.               |
+  +----------------------------------------------------------------------+
+  | Author: Youlin Feng <fengyoulin@php7th.com>                          |
+  +----------------------------------------------------------------------+
+*/
+
+/* $Id$ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "php.h"
+#include "php_ini.h"
+#include "ext/standard/info.h"
+#include "php_zendump.h"
+
+ZEND_EXTERN_MODULE_GLOBALS(zendump)
+
+#define TYPE_PROFILE_CLASSES 4
+
+typedef struct _zendump_type_slot {
+	zend_string *name;
+	zend_bool   declared;
+	uint64_t    samples;
+	uint32_t    mask;
+	zend_bool   other_classes;
+	zend_string *classes[TYPE_PROFILE_CLASSES];
+} zendump_type_slot;
+
+static const char *zendump_type_hint_name(uint32_t type)
+{
+	switch(type) {
+		case IS_NULL:
+			return "null";
+		case _IS_BOOL:
+			return "bool";
+		case IS_LONG:
+			return "int";
+		case IS_DOUBLE:
+			return "float";
+		case IS_STRING:
+			return "string";
+		case IS_ARRAY:
+			return "array";
+		case IS_OBJECT:
+			return "object";
+		case IS_RESOURCE:
+			return "resource";
+	}
+	return "mixed";
+}
+
+void zendump_type_profile_free(zendump_op_array_profile *profile)
+{
+	uint32_t idx, num;
+
+	for(idx = 0; idx < profile->types_count; ++idx) {
+		if(profile->types[idx].name) {
+			zend_string_release(profile->types[idx].name);
+		}
+		for(num = 0; num < TYPE_PROFILE_CLASSES && profile->types[idx].classes[num]; ++num) {
+			zend_string_release(profile->types[idx].classes[num]);
+		}
+	}
+	efree(profile->types);
+	profile->types = NULL;
+}
+
+static void zendump_type_record(zendump_type_slot *slot, zval *val)
+{
+	uint32_t type, idx;
+
+	ZVAL_DEREF(val);
+	type = Z_TYPE_P(val);
+	if(type == IS_FALSE || type == IS_TRUE) {
+		type = _IS_BOOL;
+	}
+	++slot->samples;
+	slot->mask |= 1 << type;
+	if(type != IS_OBJECT) {
+		return;
+	}
+	for(idx = 0; idx < TYPE_PROFILE_CLASSES && slot->classes[idx]; ++idx) {
+		if(zend_string_equals(slot->classes[idx], Z_OBJCE_P(val)->name)) {
+			return;
+		}
+	}
+	if(idx < TYPE_PROFILE_CLASSES) {
+		slot->classes[idx] = zend_string_copy(Z_OBJCE_P(val)->name);
+	} else {
+		slot->other_classes = 1;
+	}
+}
+
+static int zendump_type_declared(zend_op_array *op_array, uint32_t idx)
+{
+	zend_arg_info *info;
+
+	if(idx == op_array->num_args) {
+		if(!(op_array->fn_flags & ZEND_ACC_HAS_RETURN_TYPE)) {
+			return 0;
+		}
+		info = op_array->arg_info - 1;
+	} else {
+		info = op_array->arg_info + idx;
+	}
+#if PHP_API_VERSION >= 20170718
+	return ZEND_TYPE_IS_SET(info->type);
+#else
+	return info->type_hint != IS_UNDEF;
+#endif
+}
+
+/* One slot per declared parameter plus one for the return value. */
+static zendump_type_slot *zendump_type_slots(zend_op_array *op_array)
+{
+	zendump_op_array_profile *profile = zendump_profile_find(op_array, 1);
+	uint32_t idx;
+
+	if(!profile->types) {
+		profile->types_count = op_array->num_args + 1;
+		profile->types = ecalloc(profile->types_count, sizeof(zendump_type_slot));
+		for(idx = 0; idx < profile->types_count; ++idx) {
+			profile->types[idx].name = idx < op_array->num_args ? zend_string_copy(op_array->arg_info[idx].name) : NULL;
+			profile->types[idx].declared = zendump_type_declared(op_array, idx);
+		}
+	}
+	return profile->types;
+}
+
+/* A generator re-enters execute_ex on every resume, right after the YIELD
+   it suspended on or at the YIELD_FROM it delegates from, and on PHP 7.1+
+   right after the GENERATOR_CREATE of the call the first time. By then the
+   body may have reassigned the argument slots, so only the call counts. */
+static int zendump_type_profile_resumed(zend_execute_data *execute_data, zend_op_array *op_array)
+{
+	const zend_op *opline = EX(opline);
+
+	if(!(op_array->fn_flags & ZEND_ACC_GENERATOR) || !opline) {
+		return 0;
+	}
+	if(opline->opcode == ZEND_YIELD_FROM) {
+		return 1;
+	}
+	if(opline == op_array->opcodes) {
+		return 0;
+	}
+#if PHP_API_VERSION >= 20160303
+	if(opline[-1].opcode == ZEND_GENERATOR_CREATE) {
+		return 1;
+	}
+#endif
+	return opline[-1].opcode == ZEND_YIELD || opline[-1].opcode == ZEND_YIELD_FROM;
+}
+
+/* Called from the execute_ex hook before the first opline runs. The passed
+   arguments are already in the first CV slots, and PHP 7.1+ skips the RECV
+   oplines of untyped parameters, so they cannot be observed there. */
+void zendump_type_profile_enter(zend_execute_data *execute_data)
+{
+	zend_op_array *op_array = &EX(func)->op_array;
+	zendump_type_slot *slots;
+	uint32_t idx, count = ZEND_CALL_NUM_ARGS(execute_data);
+
+	if(!op_array->function_name || !op_array->num_args || zendump_type_profile_resumed(execute_data, op_array)) {
+		return;
+	}
+	if(count > op_array->num_args) {
+		count = op_array->num_args;
+	}
+	slots = zendump_type_slots(op_array);
+	for(idx = 0; idx < count; ++idx) {
+		zendump_type_record(slots + idx, ZEND_CALL_ARG(execute_data, idx + 1));
+	}
+}
+
+/* Return values are taken from the RETURN operand, because the caller
+   passes no return_value when the result is unused. */
+void zendump_type_profile_observe(zend_execute_data *execute_data, const zend_op *opline)
+{
+	zend_op_array *op_array = &EX(func)->op_array;
+	zval *val;
+
+	if(!op_array->function_name || (op_array->fn_flags & ZEND_ACC_GENERATOR)) {
+		return;
+	}
+	val = zendump_operand_zval(execute_data, opline->op1_type, &opline->op1);
+	if(val) {
+		zendump_type_record(zendump_type_slots(op_array) + op_array->num_args, val);
+	}
+}
+
+/* A slot is monomorphic when it saw a single type, possibly with null, and
+   at most one class; nullable types need PHP 7.1 to be declared. */
+static int zendump_type_monomorphic(zendump_type_slot *slot)
+{
+	uint32_t mask = slot->mask & ~(1 << IS_NULL);
+	if(!slot->samples || !mask || (mask & (mask - 1))) {
+		return 0;
+	}
+	if((mask & (1 << IS_OBJECT)) && (slot->other_classes || slot->classes[1])) {
+		return 0;
+	}
+	return 1;
+}
+
+static int zendump_type_hintable(zendump_type_slot *slot)
+{
+	return !slot->declared && zendump_type_monomorphic(slot);
+}
+
+static void zendump_type_slot_dump(zendump_type_slot *slot)
+{
+	uint32_t type, idx, first = 1;
+
+	if(slot->name) {
+		php_printf("%*c$%s ", INDENT_SIZE * 2, ' ', ZSTR_VAL(slot->name));
+	} else {
+		php_printf("%*creturn ", INDENT_SIZE * 2, ' ');
+	}
+
+	if(zendump_type_monomorphic(slot) && (slot->mask & (1 << IS_NULL))) {
+		PUTS("?");
+	}
+	for(type = 0; type < 32; ++type) {
+		if(!(slot->mask & (1 << type)) || (type == IS_NULL && zendump_type_monomorphic(slot))) {
+			continue;
+		}
+		if(!first) {
+			PUTS("|");
+		}
+		first = 0;
+		if(type == IS_OBJECT && slot->classes[0]) {
+			for(idx = 0; idx < TYPE_PROFILE_CLASSES && slot->classes[idx]; ++idx) {
+				php_printf("%s%s", idx ? "|" : "", ZSTR_VAL(slot->classes[idx]));
+			}
+			if(slot->other_classes) {
+				PUTS("|...");
+			}
+		} else {
+			PUTS(zendump_type_hint_name(type));
+		}
+	}
+	php_printf(" samples(%" PRIu64 ") %s%s\n", slot->samples, zendump_type_monomorphic(slot) ? "monomorphic" : "polymorphic", slot->declared ? " declared" : "");
+}
+
+void zendump_type_profile_dump(zend_long limit, zend_bool hintable_only)
+{
+	zendump_op_array_profile *profile;
+	uint32_t count = 0, idx;
+
+	php_printf("types: {\n");
+	if(ZENDUMP_G(profiles)) {
+		ZEND_HASH_FOREACH_PTR(ZENDUMP_G(profiles), profile) {
+			zendump_type_slot *slots = profile->types;
+			uint32_t shown = 0;
+			if(!slots || !profile->function_name || (limit > 0 && count >= limit)) {
+				continue;
+			}
+			for(idx = 0; idx < profile->types_count; ++idx) {
+				if(slots[idx].samples && (!hintable_only || zendump_type_hintable(slots + idx))) {
+					++shown;
+				}
+			}
+			if(!shown) {
+				continue;
+			}
+			++count;
+			php_printf("%*c%s%s%s() %s: {\n", INDENT_SIZE, ' ',
+				profile->scope_name ? ZSTR_VAL(profile->scope_name) : "",
+				profile->scope_name ? "::" : "",
+				ZSTR_VAL(profile->function_name),
+				profile->filename ? ZSTR_VAL(profile->filename) : "-");
+			for(idx = 0; idx < profile->types_count; ++idx) {
+				if(!slots[idx].samples || (hintable_only && !zendump_type_hintable(slots + idx))) {
+					continue;
+				}
+				zendump_type_slot_dump(slots + idx);
+			}
+			php_printf("%*c}\n", INDENT_SIZE, ' ');
+		} ZEND_HASH_FOREACH_END();
+	}
+	PUTS("}\n");
+}
@@ -26,6 +26,13 @@
 #include "php_ini.h"
 #include "ext/standard/info.h"
 #include "php_zendump.h"
+#include "zend_smart_str.h"
+
+#ifndef PHP_WIN32
+#include <time.h>
+#endif
+
+#define SUMMARY_STRING_LIMIT 64
 
 size_t zendump_errorf(const char *format, ...)
 {
@@ -38,3 +45,123 @@ size_t zendump_errorf(const char *format, ...)
 
   return ret;
 }
+
+uint64_t zendump_time_ns()
+{
+#ifdef PHP_WIN32
+  static LARGE_INTEGER frequency;
+  LARGE_INTEGER counter;
+
+  if(!frequency.QuadPart) {
+    QueryPerformanceFrequency(&frequency);
+  }
+  QueryPerformanceCounter(&counter);
+  return (uint64_t)((double)counter.QuadPart * 1000000000.0 / (double)frequency.QuadPart);
+#else
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+#endif
+}
+
+static void zendump_pool_record_dtor(zval *zv)
+{
+  pefree(Z_PTR_P(zv), 1);
+}
+
+/* Pool-wide records outlive the request, so both the table and its keys
+   are allocated persistently and survive until the module shuts down. */
+void *zendump_pool_record(HashTable **pool, const char *key, size_t key_len, size_t size, dtor_func_t dtor)
+{
+  void *record;
+
+  if(!*pool) {
+    *pool = pemalloc(sizeof(HashTable), 1);
+    zend_hash_init(*pool, 32, NULL, dtor ? dtor : zendump_pool_record_dtor, 1);
+  }
+  record = zend_hash_str_find_ptr(*pool, key, key_len);
+  if(!record) {
+    record = pecalloc(1, size, 1);
+    zend_hash_str_add_new_ptr(*pool, key, key_len, record);
+  }
+  return record;
+}
+
+void zendump_pool_destroy(HashTable **pool)
+{
+  if(*pool) {
+    zend_hash_destroy(*pool);
+    pefree(*pool, 1);
+    *pool = NULL;
+  }
+}
+
+/* A single-line rendering of a value for logs and traces: scalars are
+   printed in full, strings are cut and arrays and objects summarized. */
+void zendump_zval_summary_append(smart_str *buf, zval *val)
+{
+  if(Z_TYPE_P(val) == IS_INDIRECT) {
+    val = Z_INDIRECT_P(val);
+  }
+  if(Z_ISREF_P(val)) {
+    smart_str_appendc(buf, '&');
+    val = Z_REFVAL_P(val);
+  }
+  switch(Z_TYPE_P(val)) {
+    case IS_UNDEF:
+      smart_str_appends(buf, "undefined");
+      break;
+    case IS_NULL:
+      smart_str_appends(buf, "null");
+      break;
+    case IS_FALSE:
+      smart_str_appends(buf, "false");
+      break;
+    case IS_TRUE:
+      smart_str_appends(buf, "true");
+      break;
+    case IS_LONG:
+      smart_str_appends(buf, "long(");
+      smart_str_append_long(buf, Z_LVAL_P(val));
+      smart_str_appendc(buf, ')');
+      break;
+    case IS_DOUBLE: {
+      char num[64];
+      snprintf(num, sizeof(num), "double(%.*G)", (int)EG(precision), Z_DVAL_P(val));
+      smart_str_appends(buf, num);
+      break;
+    }
+    case IS_STRING: {
+      size_t idx, len = MIN(Z_STRLEN_P(val), SUMMARY_STRING_LIMIT);
+      smart_str_appends(buf, "string(");
+      smart_str_append_unsigned(buf, Z_STRLEN_P(val));
+      smart_str_appends(buf, ",\"");
+      for(idx = 0; idx < len; ++idx) {
+        char c = Z_STRVAL_P(val)[idx];
+        smart_str_appendc(buf, (c == '\n' || c == '\r' || c == '\t' || c == '\0') ? ' ' : c);
+      }
+      smart_str_appends(buf, len < Z_STRLEN_P(val) ? "...\")" : "\")");
+      break;
+    }
+    case IS_ARRAY:
+      smart_str_appends(buf, "array(");
+      smart_str_append_unsigned(buf, zend_hash_num_elements(Z_ARRVAL_P(val)));
+      smart_str_appendc(buf, ')');
+      break;
+    case IS_OBJECT:
+      smart_str_appends(buf, "object(");
+      smart_str_append(buf, Z_OBJCE_P(val)->name);
+      smart_str_appends(buf, ")#");
+      smart_str_append_unsigned(buf, Z_OBJ_HANDLE_P(val));
+      break;
+    case IS_RESOURCE:
+      smart_str_appends(buf, "resource(");
+      smart_str_append_long(buf, Z_RES_HANDLE_P(val));
+      smart_str_appendc(buf, ')');
+      break;
+    default:
+      smart_str_appends(buf, zendump_get_type_name(Z_TYPE_P(val)));
+      break;
+  }
+}
@@ -0,0 +1,238 @@
+/*
+  +----------------------------------------------------------------------+
+  | PHP Version 7                                                        |
+  +----------------------------------------------------------------------+
+  | Copyright (c) 1997-2018 The PHP Group                                |
+  +----------------------------------------------------------------------+
+  | This source file is subject to version 3.01 of the PHP license,      |
+  | that is bundled with this package in the file LICENSE, and is        |
+  | available through the world-wide-web at the following url:           |
+  | http://www.php.net/license/3_01.txt                                  |
+  | If you did not receive a copy of the PHP license and are unable to   |
+  | obtain it through the world-wide-web, please send a note to          |
+  | license@php.net so we can mail you a copy immediately.               |
+  +----------------------------------------------------------------------+
+  | Author: Youlin Feng <fengyoulin@php7th.com>                          |
+  +----------------------------------------------------------------------+
+*/
+
+/* $Id$ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "php.h"
+#include "php_ini.h"
+#include "ext/standard/info.h"
+#include "php_zendump.h"
+#include "SAPI.h"
+#include "zend_smart_str.h"
+
+ZEND_EXTERN_MODULE_GLOBALS(zendump)
+
+#ifdef ZENDUMP_WATCHDOG
+
+#include <time.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+/* The watchdog is only built without ZTS, so the timer state can live in
+   plain statics that the notification thread is allowed to touch. Timers
+   are not inherited across fork(), so each worker creates its own on its
+   first request. */
+static timer_t zendump_watchdog_timer;
+static pid_t zendump_watchdog_owner = 0;
+static volatile int zendump_watchdog_fired = 0;
+static uint64_t zendump_watchdog_start = 0;
+static void (*zendump_origin_interrupt_function)(zend_execute_data *execute_data) = NULL;
+
+/* Runs on a helper thread, the VM picks the interrupt up on its next jump
+   or call, so the executing thread is never hit by a signal. */
+static void zendump_watchdog_notify(union sigval value)
+{
+	zendump_watchdog_fired = 1;
+	EG(vm_interrupt) = 1;
+}
+
+static int zendump_watchdog_arm(zend_long ms)
+{
+	struct itimerspec spec;
+
+	memset(&spec, 0, sizeof(spec));
+	spec.it_value.tv_sec = ms / 1000;
+	spec.it_value.tv_nsec = (ms % 1000) * 1000000;
+	return timer_settime(zendump_watchdog_timer, 0, &spec, NULL);
+}
+
+/* One line per frame followed by its arguments and, for user code, its
+   compiled variables, the same slots zendump_args() and zendump_vars()
+   read. The values are only summarized, so a frame costs a bounded number
+   of bytes. */
+static void zendump_watchdog_frame(smart_str *buf, zend_execute_data *ex, uint32_t depth)
+{
+	zend_function *func = ex->func;
+	uint32_t idx, count = ZEND_CALL_NUM_ARGS(ex);
+
+	smart_str_appends(buf, "  #");
+	smart_str_append_unsigned(buf, depth);
+	smart_str_appendc(buf, ' ');
+	if(func->common.scope) {
+		smart_str_append(buf, func->common.scope->name);
+		smart_str_appends(buf, "::");
+	}
+	smart_str_appends(buf, func->common.function_name ? ZSTR_VAL(func->common.function_name) : "{main}");
+	smart_str_appends(buf, "()");
+	if(ZEND_USER_CODE(func->type)) {
+		smart_str_appendc(buf, ' ');
+		smart_str_append(buf, func->op_array.filename);
+		smart_str_appendc(buf, ':');
+		smart_str_append_unsigned(buf, ex->opline ? ex->opline->lineno : 0);
+	}
+	smart_str_appendc(buf, '\n');
+
+	if(count && (!ZEND_USER_CODE(func->type) || count > func->op_array.num_args)) {
+		uint32_t first = ZEND_USER_CODE(func->type) ? func->op_array.num_args : 0;
+		smart_str_appends(buf, "    args:");
+		for(idx = first; idx < count; ++idx) {
+			zval *val = ZEND_USER_CODE(func->type) ? ZEND_CALL_VAR_NUM(ex, func->op_array.last_var + func->op_array.T + idx - first) : ZEND_CALL_ARG(ex, idx + 1);
+			smart_str_appendc(buf, ' ');
+			zendump_zval_summary_append(buf, val);
+		}
+		smart_str_appendc(buf, '\n');
+	}
+	if(ZEND_USER_CODE(func->type)) {
+		for(idx = 0; idx < func->op_array.last_var; ++idx) {
+			smart_str_appends(buf, "    $");
+			smart_str_append(buf, func->op_array.vars[idx]);
+			smart_str_appends(buf, " = ");
+			zendump_zval_summary_append(buf, ZEND_CALL_VAR_NUM(ex, idx));
+			smart_str_appendc(buf, '\n');
+		}
+	}
+}
+
+static void zendump_watchdog_capture(zend_execute_data *execute_data)
+{
+	smart_str buf = {0};
+	zend_execute_data *ex;
+	size_t limit = (size_t)ZENDUMP_G(watchdog_max_size);
+	uint32_t depth = 0;
+	int fd;
+
+	smart_str_appends(&buf, "watchdog pid(");
+	smart_str_append_long(&buf, (zend_long)getpid());
+	smart_str_appends(&buf, ") elapsed(");
+	smart_str_append_unsigned(&buf, (zend_ulong)((zendump_time_ns() - zendump_watchdog_start) / 1000000));
+	smart_str_appends(&buf, "ms) script(");
+	smart_str_appends(&buf, SG(request_info).path_translated ? SG(request_info).path_translated : "-");
+	smart_str_appends(&buf, ") uri(");
+	smart_str_appends(&buf, SG(request_info).request_uri ? SG(request_info).request_uri : "-");
+	smart_str_appends(&buf, "): {\n");
+	for(ex = execute_data; ex; ex = ex->prev_execute_data) {
+		size_t mark = buf.s ? ZSTR_LEN(buf.s) : 0;
+		if(!ex->func) {
+			continue;
+		}
+		zendump_watchdog_frame(&buf, ex, depth++);
+		if(limit && ZSTR_LEN(buf.s) + sizeof("  ...\n}\n") > limit) {
+			ZSTR_LEN(buf.s) = mark;
+			smart_str_appends(&buf, "  ...\n");
+			break;
+		}
+	}
+	smart_str_appends(&buf, "}\n");
+	smart_str_0(&buf);
+
+	if(ZENDUMP_G(watchdog_log) && *ZENDUMP_G(watchdog_log)) {
+		fd = open(ZENDUMP_G(watchdog_log), O_WRONLY | O_APPEND | O_CREAT, 0644);
+	} else {
+		fd = STDERR_FILENO;
+	}
+	if(fd >= 0) {
+		if(write(fd, ZSTR_VAL(buf.s), ZSTR_LEN(buf.s)) < 0) {
+			/* nothing sensible to report from inside the VM */
+		}
+		if(fd != STDERR_FILENO) {
+			close(fd);
+		}
+	}
+	smart_str_free(&buf);
+}
+
+static void zendump_watchdog_interrupt(zend_execute_data *execute_data)
+{
+	if(zendump_watchdog_fired) {
+		zendump_watchdog_fired = 0;
+		zendump_watchdog_capture(execute_data);
+	}
+	if(zendump_origin_interrupt_function) {
+		zendump_origin_interrupt_function(execute_data);
+	}
+}
+
+void zendump_watchdog_startup()
+{
+	zendump_origin_interrupt_function = zend_interrupt_function;
+	zend_interrupt_function = zendump_watchdog_interrupt;
+}
+
+void zendump_watchdog_shutdown()
+{
+	if(zend_interrupt_function == zendump_watchdog_interrupt) {
+		zend_interrupt_function = zendump_origin_interrupt_function;
+	}
+	if(zendump_watchdog_owner == getpid()) {
+		timer_delete(zendump_watchdog_timer);
+		zendump_watchdog_owner = 0;
+	}
+}
+
+void zendump_watchdog_activate()
+{
+	struct sigevent event;
+
+	if(zendump_watchdog_owner != getpid()) {
+		memset(&event, 0, sizeof(event));
+		event.sigev_notify = SIGEV_THREAD;
+		event.sigev_notify_function = zendump_watchdog_notify;
+		if(timer_create(CLOCK_MONOTONIC, &event, &zendump_watchdog_timer) != 0) {
+			php_error_docref(NULL, E_WARNING, "Failed to create the watchdog timer: %s", strerror(errno));
+			return;
+		}
+		zendump_watchdog_owner = getpid();
+	}
+	zendump_watchdog_fired = 0;
+	zendump_watchdog_start = zendump_time_ns();
+	zendump_watchdog_arm(ZENDUMP_G(watchdog_threshold));
+}
+
+void zendump_watchdog_deactivate()
+{
+	if(zendump_watchdog_owner == getpid()) {
+		zendump_watchdog_arm(0);
+	}
+	zendump_watchdog_fired = 0;
+}
+
+#else
+
+void zendump_watchdog_startup()
+{
+	php_error_docref(NULL, E_WARNING, "zendump.watchdog_threshold needs a non-ZTS build of PHP 7.1 or later with timer_create()");
+}
+
+void zendump_watchdog_shutdown()
+{
+}
+
+void zendump_watchdog_activate()
+{
+}
+
+void zendump_watchdog_deactivate()
+{
+}
+
+#endif
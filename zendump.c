@@ -38,6 +38,27 @@ PHP_INI_BEGIN()
 	STD_PHP_INI_ENTRY("zendump.enable_trace",  "false",  PHP_INI_ALL, OnUpdateBool,   enable_trace,  zend_zendump_globals, zendump_globals)
 	STD_PHP_INI_ENTRY("zendump.global_value",  "0",      PHP_INI_ALL, OnUpdateLong,   global_value,  zend_zendump_globals, zendump_globals)
 	STD_PHP_INI_ENTRY("zendump.global_string", "foobar", PHP_INI_ALL, OnUpdateString, global_string, zend_zendump_globals, zendump_globals)
+	STD_PHP_INI_ENTRY("zendump.enable_cow_trace", "false", PHP_INI_SYSTEM, OnUpdateBool, enable_cow_trace, zend_zendump_globals, zendump_globals)
+	STD_PHP_INI_ENTRY("zendump.enable_properties_trace", "false", PHP_INI_SYSTEM, OnUpdateBool, enable_properties_trace, zend_zendump_globals, zendump_globals)
+	STD_PHP_INI_ENTRY("zendump.enable_immutable_trace", "false", PHP_INI_SYSTEM, OnUpdateBool, enable_immutable_trace, zend_zendump_globals, zendump_globals)
+	STD_PHP_INI_ENTRY("zendump.enable_opcode_profile", "false", PHP_INI_SYSTEM, OnUpdateBool, enable_opcode_profile, zend_zendump_globals, zendump_globals)
+	STD_PHP_INI_ENTRY("zendump.enable_line_profile", "false", PHP_INI_SYSTEM, OnUpdateBool, enable_line_profile, zend_zendump_globals, zendump_globals)
+	STD_PHP_INI_ENTRY("zendump.enable_loop_profile", "false", PHP_INI_SYSTEM, OnUpdateBool, enable_loop_profile, zend_zendump_globals, zendump_globals)
+	STD_PHP_INI_ENTRY("zendump.loop_report_limit", "0", PHP_INI_ALL, OnUpdateLong, loop_report_limit, zend_zendump_globals, zendump_globals)
+	STD_PHP_INI_ENTRY("zendump.enable_coverage", "false", PHP_INI_SYSTEM, OnUpdateBool, enable_coverage, zend_zendump_globals, zendump_globals)
+	STD_PHP_INI_ENTRY("zendump.enable_compile_profile", "false", PHP_INI_SYSTEM, OnUpdateBool, enable_compile_profile, zend_zendump_globals, zendump_globals)
+	STD_PHP_INI_ENTRY("zendump.enable_autoload_trace", "false", PHP_INI_SYSTEM, OnUpdateBool, enable_autoload_trace, zend_zendump_globals, zendump_globals)
+	STD_PHP_INI_ENTRY("zendump.enable_preload_trace", "false", PHP_INI_SYSTEM, OnUpdateBool, enable_preload_trace, zend_zendump_globals, zendump_globals)
+	STD_PHP_INI_ENTRY("zendump.enable_cache_profile", "false", PHP_INI_SYSTEM, OnUpdateBool, enable_cache_profile, zend_zendump_globals, zendump_globals)
+	STD_PHP_INI_ENTRY("zendump.enable_receiver_profile", "false", PHP_INI_SYSTEM, OnUpdateBool, enable_receiver_profile, zend_zendump_globals, zendump_globals)
+	STD_PHP_INI_ENTRY("zendump.enable_type_profile", "false", PHP_INI_SYSTEM, OnUpdateBool, enable_type_profile, zend_zendump_globals, zendump_globals)
+	STD_PHP_INI_ENTRY("zendump.enable_gc_profile", "false", PHP_INI_SYSTEM, OnUpdateBool, enable_gc_profile, zend_zendump_globals, zendump_globals)
+	STD_PHP_INI_ENTRY("zendump.enable_error_trace", "false", PHP_INI_SYSTEM, OnUpdateBool, enable_error_trace, zend_zendump_globals, zendump_globals)
+	STD_PHP_INI_ENTRY("zendump.watchdog_threshold", "0", PHP_INI_SYSTEM, OnUpdateLong, watchdog_threshold, zend_zendump_globals, zendump_globals)
+	STD_PHP_INI_ENTRY("zendump.watchdog_log", "", PHP_INI_SYSTEM, OnUpdateString, watchdog_log, zend_zendump_globals, zendump_globals)
+	STD_PHP_INI_ENTRY("zendump.watchdog_max_size", "65536", PHP_INI_SYSTEM, OnUpdateLong, watchdog_max_size, zend_zendump_globals, zendump_globals)
+	STD_PHP_INI_ENTRY("zendump.backtrace_buffer_size", "4096", PHP_INI_SYSTEM, OnUpdateLong, backtrace_buffer_size, zend_zendump_globals, zendump_globals)
+	STD_PHP_INI_ENTRY("zendump.backtrace_log", "", PHP_INI_SYSTEM, OnUpdateString, backtrace_log, zend_zendump_globals, zendump_globals)
 PHP_INI_END()
 /* }}} */
 
@@ -455,6 +476,26 @@ PHP_FUNCTION(zendump_class)
 	zendump_zend_class_entry_dump(Z_CE_P(val), show_magic_functions, column_width);
 }
 
+PHP_FUNCTION(zendump_class_layout)
+{
+	zval *val = NULL;
+	char *buf = NULL;
+	size_t buf_len;
+
+	ZEND_PARSE_PARAMETERS_START(1, 1)
+		Z_PARAM_STRING(buf, buf_len)
+	ZEND_PARSE_PARAMETERS_END();
+
+	zendump_string_to_lower(buf, buf_len);
+
+	val = zend_hash_str_find(EG(class_table), buf, buf_len);
+	if(!val || !Z_CE_P(val)) {
+		return;
+	}
+
+	zendump_class_layout_dump(Z_CE_P(val));
+}
+
 PHP_FUNCTION(zendump_method)
 {
 	zval *val = NULL;
@@ -485,6 +526,448 @@ PHP_FUNCTION(zendump_method)
 	zendump_zend_function_dump(Z_FUNC_P(val), column_width);
 }
 
+PHP_FUNCTION(zendump_cow_report)
+{
+	zend_long limit = 0;
+
+	ZEND_PARSE_PARAMETERS_START(0, 1)
+		Z_PARAM_OPTIONAL
+		Z_PARAM_LONG(limit)
+	ZEND_PARSE_PARAMETERS_END();
+
+	if(!ZENDUMP_G(enable_cow_trace)) {
+		php_error_docref(NULL, E_WARNING, "zendump.enable_cow_trace is off");
+		return;
+	}
+
+	zendump_cow_report(limit);
+}
+
+PHP_FUNCTION(zendump_objects_survey)
+{
+	zend_long limit = 0;
+
+	ZEND_PARSE_PARAMETERS_START(0, 1)
+		Z_PARAM_OPTIONAL
+		Z_PARAM_LONG(limit)
+	ZEND_PARSE_PARAMETERS_END();
+
+	zendump_objects_survey(limit);
+}
+
+PHP_FUNCTION(zendump_string_audit)
+{
+	zend_long limit = 20;
+
+	ZEND_PARSE_PARAMETERS_START(0, 1)
+		Z_PARAM_OPTIONAL
+		Z_PARAM_LONG(limit)
+	ZEND_PARSE_PARAMETERS_END();
+
+	zendump_string_audit(limit);
+}
+
+PHP_FUNCTION(zendump_immutable_audit)
+{
+	zend_long min_elements = 8;
+
+	ZEND_PARSE_PARAMETERS_START(0, 1)
+		Z_PARAM_OPTIONAL
+		Z_PARAM_LONG(min_elements)
+	ZEND_PARSE_PARAMETERS_END();
+
+	zendump_immutable_audit(min_elements);
+}
+
+PHP_FUNCTION(zendump_opcode_mix)
+{
+	zend_long limit = 0;
+	zend_long column_width = 35;
+
+	ZEND_PARSE_PARAMETERS_START(0, 2)
+		Z_PARAM_OPTIONAL
+		Z_PARAM_LONG(limit)
+		Z_PARAM_LONG(column_width)
+	ZEND_PARSE_PARAMETERS_END();
+
+	if(!ZENDUMP_G(enable_opcode_profile)) {
+		php_error_docref(NULL, E_WARNING, "zendump.enable_opcode_profile is off");
+		return;
+	}
+
+	zendump_opcode_mix_dump(limit, column_width);
+}
+
+PHP_FUNCTION(zendump_line_profile)
+{
+	char *callgrind = NULL;
+	size_t callgrind_len = 0;
+
+	ZEND_PARSE_PARAMETERS_START(0, 1)
+		Z_PARAM_OPTIONAL
+		Z_PARAM_PATH(callgrind, callgrind_len)
+	ZEND_PARSE_PARAMETERS_END();
+
+	if(!ZENDUMP_G(enable_line_profile)) {
+		php_error_docref(NULL, E_WARNING, "zendump.enable_line_profile is off");
+		RETURN_FALSE;
+	}
+
+	if(callgrind_len && zendump_line_profile_callgrind(callgrind) == FAILURE) {
+		RETURN_FALSE;
+	}
+
+	zendump_line_profile_collect(return_value);
+}
+
+/* Looks up a user function by "name" or a user method by "class::method". */
+static zend_function *zendump_user_function_find(char *buf, size_t buf_len)
+{
+	zval *val = NULL;
+	char *sep;
+
+	zendump_string_to_lower(buf, buf_len);
+
+	sep = strstr(buf, "::");
+	if(sep) {
+		val = zend_hash_str_find(EG(class_table), buf, sep - buf);
+		if(!val || !Z_CE_P(val)) {
+			return NULL;
+		}
+		val = zend_hash_str_find(&Z_CE_P(val)->function_table, sep + 2, buf_len - (sep - buf) - 2);
+	} else {
+		val = zend_hash_str_find(EG(function_table), buf, buf_len);
+	}
+	if(!val || !Z_FUNC_P(val) || Z_FUNC_P(val)->type != ZEND_USER_FUNCTION) {
+		return NULL;
+	}
+	return Z_FUNC_P(val);
+}
+
+PHP_FUNCTION(zendump_cfg)
+{
+	zend_function *func;
+	char *buf = NULL, *format = "dot";
+	size_t buf_len, format_len = 3;
+
+	ZEND_PARSE_PARAMETERS_START(1, 2)
+		Z_PARAM_STRING(buf, buf_len)
+		Z_PARAM_OPTIONAL
+		Z_PARAM_STRING(format, format_len)
+	ZEND_PARSE_PARAMETERS_END();
+
+	if(strcmp(format, "dot") && strcmp(format, "json")) {
+		php_error_docref(NULL, E_WARNING, "Unknown format '%s', expecting 'dot' or 'json'", format);
+		RETURN_FALSE;
+	}
+
+	func = zendump_user_function_find(buf, buf_len);
+	if(!func) {
+		RETURN_FALSE;
+	}
+
+	RETURN_STR(zendump_cfg_export(&func->op_array, !strcmp(format, "json")));
+}
+
+PHP_FUNCTION(zendump_hot_loops)
+{
+	zend_long limit = 10;
+
+	ZEND_PARSE_PARAMETERS_START(0, 1)
+		Z_PARAM_OPTIONAL
+		Z_PARAM_LONG(limit)
+	ZEND_PARSE_PARAMETERS_END();
+
+	if(!ZENDUMP_G(enable_loop_profile)) {
+		php_error_docref(NULL, E_WARNING, "zendump.enable_loop_profile is off");
+		return;
+	}
+
+	zendump_hot_loops_dump(limit, 0);
+}
+
+PHP_FUNCTION(zendump_coverage_start)
+{
+	ZEND_PARSE_PARAMETERS_START(0, 0)
+	ZEND_PARSE_PARAMETERS_END();
+
+	if(!ZENDUMP_G(enable_coverage)) {
+		php_error_docref(NULL, E_WARNING, "zendump.enable_coverage is off");
+		RETURN_FALSE;
+	}
+
+	zendump_coverage_start();
+	RETURN_TRUE;
+}
+
+PHP_FUNCTION(zendump_coverage_stop)
+{
+	ZEND_PARSE_PARAMETERS_START(0, 0)
+	ZEND_PARSE_PARAMETERS_END();
+
+	if(!ZENDUMP_G(enable_coverage)) {
+		php_error_docref(NULL, E_WARNING, "zendump.enable_coverage is off");
+		RETURN_FALSE;
+	}
+
+	zendump_coverage_stop(return_value);
+}
+
+PHP_FUNCTION(zendump_codebase_stats)
+{
+	zend_long limit = 10;
+	zend_long column_width = 35;
+
+	ZEND_PARSE_PARAMETERS_START(0, 2)
+		Z_PARAM_OPTIONAL
+		Z_PARAM_LONG(limit)
+		Z_PARAM_LONG(column_width)
+	ZEND_PARSE_PARAMETERS_END();
+
+	zendump_codebase_stats(limit, column_width);
+}
+
+PHP_FUNCTION(zendump_compile_profile)
+{
+	zend_long limit = 0;
+
+	ZEND_PARSE_PARAMETERS_START(0, 1)
+		Z_PARAM_OPTIONAL
+		Z_PARAM_LONG(limit)
+	ZEND_PARSE_PARAMETERS_END();
+
+	if(!ZENDUMP_G(enable_compile_profile)) {
+		php_error_docref(NULL, E_WARNING, "zendump.enable_compile_profile is off");
+		return;
+	}
+
+	zendump_compile_profile_dump(limit);
+}
+
+PHP_FUNCTION(zendump_autoload_profile)
+{
+	zend_long limit = 0;
+	zend_bool pool = 0;
+
+	ZEND_PARSE_PARAMETERS_START(0, 2)
+		Z_PARAM_OPTIONAL
+		Z_PARAM_LONG(limit)
+		Z_PARAM_BOOL(pool)
+	ZEND_PARSE_PARAMETERS_END();
+
+	if(!ZENDUMP_G(enable_autoload_trace)) {
+		php_error_docref(NULL, E_WARNING, "zendump.enable_autoload_trace is off");
+		return;
+	}
+
+	zendump_autoload_dump(limit, pool);
+}
+
+PHP_FUNCTION(zendump_preload_script)
+{
+	char *filename = NULL;
+	size_t filename_len;
+	double min_ratio = 0.5;
+	zend_long count;
+
+	ZEND_PARSE_PARAMETERS_START(1, 2)
+		Z_PARAM_PATH(filename, filename_len)
+		Z_PARAM_OPTIONAL
+		Z_PARAM_DOUBLE(min_ratio)
+	ZEND_PARSE_PARAMETERS_END();
+
+	if(!ZENDUMP_G(enable_preload_trace)) {
+		php_error_docref(NULL, E_WARNING, "zendump.enable_preload_trace is off");
+		RETURN_FALSE;
+	}
+
+	count = zendump_preload_script(filename, min_ratio);
+	if(count < 0) {
+		RETURN_FALSE;
+	}
+	RETURN_LONG(count);
+}
+
+PHP_FUNCTION(zendump_runtime_cache)
+{
+	zend_function *func;
+	char *buf = NULL;
+	size_t buf_len;
+
+	ZEND_PARSE_PARAMETERS_START(1, 1)
+		Z_PARAM_STRING(buf, buf_len)
+	ZEND_PARSE_PARAMETERS_END();
+
+	func = zendump_user_function_find(buf, buf_len);
+	if(!func) {
+		return;
+	}
+
+	zendump_runtime_cache_dump(&func->op_array);
+}
+
+PHP_FUNCTION(zendump_receiver_profile)
+{
+	zend_long limit = 0;
+	zend_long min_classes = 1;
+
+	ZEND_PARSE_PARAMETERS_START(0, 2)
+		Z_PARAM_OPTIONAL
+		Z_PARAM_LONG(limit)
+		Z_PARAM_LONG(min_classes)
+	ZEND_PARSE_PARAMETERS_END();
+
+	if(!ZENDUMP_G(enable_receiver_profile)) {
+		php_error_docref(NULL, E_WARNING, "zendump.enable_receiver_profile is off");
+		return;
+	}
+
+	zendump_receiver_dump(limit, min_classes);
+}
+
+PHP_FUNCTION(zendump_type_profile)
+{
+	zend_long limit = 0;
+	zend_bool hintable_only = 0;
+
+	ZEND_PARSE_PARAMETERS_START(0, 2)
+		Z_PARAM_OPTIONAL
+		Z_PARAM_LONG(limit)
+		Z_PARAM_BOOL(hintable_only)
+	ZEND_PARSE_PARAMETERS_END();
+
+	if(!ZENDUMP_G(enable_type_profile)) {
+		php_error_docref(NULL, E_WARNING, "zendump.enable_type_profile is off");
+		return;
+	}
+
+	zendump_type_profile_dump(limit, hintable_only);
+}
+
+PHP_FUNCTION(zendump_optimizer_diff)
+{
+	char *filename = NULL;
+	size_t filename_len;
+
+	ZEND_PARSE_PARAMETERS_START(1, 1)
+		Z_PARAM_PATH(filename, filename_len)
+	ZEND_PARSE_PARAMETERS_END();
+
+	RETURN_BOOL(zendump_optimizer_diff(filename) == SUCCESS);
+}
+
+PHP_FUNCTION(zendump_file)
+{
+	char *path = NULL, *output = NULL;
+	size_t path_len, output_len = 0;
+	zend_long column_width = 35;
+	zend_long count;
+
+	ZEND_PARSE_PARAMETERS_START(1, 3)
+		Z_PARAM_PATH(path, path_len)
+		Z_PARAM_OPTIONAL
+		Z_PARAM_PATH(output, output_len)
+		Z_PARAM_LONG(column_width)
+	ZEND_PARSE_PARAMETERS_END();
+
+	if(!output_len) {
+		RETURN_BOOL(zendump_file_dump(path, column_width) == SUCCESS);
+	}
+
+	count = zendump_file_batch(path, output, column_width);
+	if(count < 0) {
+		RETURN_FALSE;
+	}
+	RETURN_LONG(count);
+}
+
+PHP_FUNCTION(zendump_gc_profile)
+{
+	zend_long limit = 0;
+
+	ZEND_PARSE_PARAMETERS_START(0, 1)
+		Z_PARAM_OPTIONAL
+		Z_PARAM_LONG(limit)
+	ZEND_PARSE_PARAMETERS_END();
+
+	if(!ZENDUMP_G(enable_gc_profile)) {
+		php_error_docref(NULL, E_WARNING, "zendump.enable_gc_profile is off");
+		return;
+	}
+
+	zendump_gc_profile_dump(limit);
+}
+
+PHP_FUNCTION(zendump_error_profile)
+{
+	zend_long limit = 0;
+	zend_bool pool = 0;
+
+	ZEND_PARSE_PARAMETERS_START(0, 2)
+		Z_PARAM_OPTIONAL
+		Z_PARAM_LONG(limit)
+		Z_PARAM_BOOL(pool)
+	ZEND_PARSE_PARAMETERS_END();
+
+	if(!ZENDUMP_G(enable_error_trace)) {
+		php_error_docref(NULL, E_WARNING, "zendump.enable_error_trace is off");
+		return;
+	}
+
+	zendump_error_trace_dump(limit, pool);
+}
+
+PHP_FUNCTION(zendump_backtrace_capture)
+{
+	zend_long limit = 0;
+	zend_bool with_args = 0;
+	zend_long handle;
+
+	ZEND_PARSE_PARAMETERS_START(0, 2)
+		Z_PARAM_OPTIONAL
+		Z_PARAM_LONG(limit)
+		Z_PARAM_BOOL(with_args)
+	ZEND_PARSE_PARAMETERS_END();
+
+	handle = zendump_backtrace_capture(EX(prev_execute_data), limit, with_args);
+	if(handle < 0) {
+		RETURN_FALSE;
+	}
+	RETURN_LONG(handle);
+}
+
+PHP_FUNCTION(zendump_backtrace_format)
+{
+	zend_long handle;
+	zend_string *text;
+
+	ZEND_PARSE_PARAMETERS_START(1, 1)
+		Z_PARAM_LONG(handle)
+	ZEND_PARSE_PARAMETERS_END();
+
+	text = zendump_backtrace_format(handle);
+	if(!text) {
+		php_error_docref(NULL, E_WARNING, "Invalid backtrace handle " ZEND_LONG_FMT, handle);
+		RETURN_FALSE;
+	}
+	RETURN_STR(text);
+}
+
+PHP_FUNCTION(zendump_diff)
+{
+	zval *a, *b;
+	zend_long limit = 0;
+
+	ZEND_PARSE_PARAMETERS_START(2, 3)
+		Z_PARAM_ZVAL(a)
+		Z_PARAM_ZVAL(b)
+		Z_PARAM_OPTIONAL
+		Z_PARAM_LONG(limit)
+	ZEND_PARSE_PARAMETERS_END();
+
+	RETURN_LONG(zendump_diff(a, b, limit));
+}
+
 /* {{{ php_zendump_init_globals
 */
 static void php_zendump_init_globals()
@@ -492,6 +975,68 @@ static void php_zendump_init_globals()
 	ZENDUMP_G(enable_trace) = 0;
 	ZENDUMP_G(global_value) = 0;
 	ZENDUMP_G(global_string) = NULL;
+	ZENDUMP_G(enable_cow_trace) = 0;
+	ZENDUMP_G(cow_sites) = NULL;
+	ZENDUMP_G(class_layouts) = NULL;
+	ZENDUMP_G(enable_properties_trace) = 0;
+	ZENDUMP_G(properties_sites) = NULL;
+	ZENDUMP_G(properties_pending_count) = 0;
+	ZENDUMP_G(enable_immutable_trace) = 0;
+	ZENDUMP_G(literal_copies) = NULL;
+	ZENDUMP_G(enable_opcode_profile) = 0;
+	ZENDUMP_G(profiles) = NULL;
+	ZENDUMP_G(profile_cache) = NULL;
+	memset(ZENDUMP_G(opcode_hits), 0, sizeof(ZENDUMP_G(opcode_hits)));
+	ZENDUMP_G(enable_line_profile) = 0;
+	ZENDUMP_G(line_last_profile) = NULL;
+	ZENDUMP_G(enable_loop_profile) = 0;
+	ZENDUMP_G(loop_report_limit) = 0;
+	ZENDUMP_G(enable_coverage) = 0;
+	ZENDUMP_G(coverage_active) = 0;
+	ZENDUMP_G(enable_compile_profile) = 0;
+	ZENDUMP_G(origin_compile_file) = NULL;
+	ZENDUMP_G(origin_compile_string) = NULL;
+	ZENDUMP_G(compile_sites) = NULL;
+	ZENDUMP_G(enable_autoload_trace) = 0;
+	ZENDUMP_G(origin_execute_internal) = NULL;
+	ZENDUMP_G(autoload_sites) = NULL;
+	ZENDUMP_G(autoload_pool) = NULL;
+	ZENDUMP_G(autoload_depth) = 0;
+	ZENDUMP_G(autoload_requests) = 0;
+	ZENDUMP_G(enable_preload_trace) = 0;
+	ZENDUMP_G(preload_files) = NULL;
+	ZENDUMP_G(preload_seen) = NULL;
+	ZENDUMP_G(preload_counted) = 0;
+	ZENDUMP_G(preload_requests) = 0;
+	ZENDUMP_G(enable_cache_profile) = 0;
+	ZENDUMP_G(enable_receiver_profile) = 0;
+	ZENDUMP_G(receiver_sites) = NULL;
+	ZENDUMP_G(enable_type_profile) = 0;
+	ZENDUMP_G(enable_gc_profile) = 0;
+	ZENDUMP_G(gc_recording) = 0;
+	ZENDUMP_G(origin_gc_collect_cycles) = NULL;
+	ZENDUMP_G(gc_runs) = NULL;
+	ZENDUMP_G(gc_runs_count) = 0;
+	ZENDUMP_G(gc_runs_size) = 0;
+	ZENDUMP_G(gc_garbage) = NULL;
+	ZENDUMP_G(enable_error_trace) = 0;
+	ZENDUMP_G(error_recording) = 0;
+	ZENDUMP_G(origin_error_cb) = NULL;
+	ZENDUMP_G(origin_throw_exception_hook) = NULL;
+	ZENDUMP_G(exception_origins) = NULL;
+	ZENDUMP_G(error_sites) = NULL;
+	ZENDUMP_G(error_pool) = NULL;
+	ZENDUMP_G(error_requests) = 0;
+	ZENDUMP_G(watchdog_threshold) = 0;
+	ZENDUMP_G(watchdog_log) = NULL;
+	ZENDUMP_G(watchdog_max_size) = 0;
+	ZENDUMP_G(backtrace_buffer_size) = 0;
+	ZENDUMP_G(backtrace_log) = NULL;
+	ZENDUMP_G(backtrace_frames) = NULL;
+	ZENDUMP_G(backtrace_frames_used) = 0;
+	ZENDUMP_G(backtraces) = NULL;
+	ZENDUMP_G(backtrace_count) = 0;
+	ZENDUMP_G(backtrace_size) = 0;
 }
 /* }}} */
 
@@ -503,12 +1048,88 @@ PHP_MINIT_FUNCTION(zendump)
 
 	REGISTER_INI_ENTRIES();
 
-	if (ZENDUMP_G(enable_trace))
+	if (ZENDUMP_G(enable_trace) || ZENDUMP_G(enable_type_profile))
 	{
 		ZENDUMP_G(origin_execute) = zend_execute_ex;
 		zend_execute_ex = zendump_execute;
 	}
 
+	if (ZENDUMP_G(enable_cow_trace))
+	{
+		zendump_cow_startup();
+	}
+
+	if (ZENDUMP_G(enable_properties_trace))
+	{
+		zendump_observe_all_opcodes(zendump_properties_observe);
+	}
+
+	if (ZENDUMP_G(enable_immutable_trace))
+	{
+		zendump_literal_copy_startup();
+	}
+
+	if (ZENDUMP_G(enable_opcode_profile))
+	{
+		zendump_observe_all_opcodes(zendump_opcode_profile_observe);
+	}
+
+	if (ZENDUMP_G(enable_line_profile))
+	{
+		zendump_observe_all_opcodes(zendump_line_profile_observe);
+	}
+
+	if (ZENDUMP_G(enable_loop_profile))
+	{
+		zendump_loop_profile_startup();
+	}
+
+	if (ZENDUMP_G(enable_coverage))
+	{
+		zendump_observe_all_opcodes(zendump_coverage_observe);
+	}
+
+	if (ZENDUMP_G(enable_compile_profile))
+	{
+		zendump_compile_profile_startup();
+	}
+
+	if (ZENDUMP_G(enable_autoload_trace))
+	{
+		zendump_autoload_startup();
+	}
+
+	if (ZENDUMP_G(enable_cache_profile))
+	{
+		zendump_runtime_cache_startup();
+	}
+
+	if (ZENDUMP_G(enable_receiver_profile))
+	{
+		zendump_receiver_startup();
+	}
+
+	if (ZENDUMP_G(enable_type_profile))
+	{
+		zendump_observe_opcode(ZEND_RETURN, zendump_type_profile_observe);
+		zendump_observe_opcode(ZEND_RETURN_BY_REF, zendump_type_profile_observe);
+	}
+
+	if (ZENDUMP_G(enable_gc_profile))
+	{
+		zendump_gc_profile_startup();
+	}
+
+	if (ZENDUMP_G(enable_error_trace))
+	{
+		zendump_error_trace_startup();
+	}
+
+	if (ZENDUMP_G(watchdog_threshold) > 0)
+	{
+		zendump_watchdog_startup();
+	}
+
 	return SUCCESS;
 }
 /* }}} */
@@ -517,7 +1138,7 @@ PHP_MINIT_FUNCTION(zendump)
  */
 PHP_MSHUTDOWN_FUNCTION(zendump)
 {
-	if (ZENDUMP_G(enable_trace))
+	if (ZENDUMP_G(enable_trace) || ZENDUMP_G(enable_type_profile))
 	{
 		if (zend_execute_ex == zendump_execute && ZENDUMP_G(origin_execute) != NULL)
 		{
@@ -526,13 +1147,42 @@ PHP_MSHUTDOWN_FUNCTION(zendump)
 		}
 	}
 
+	if (ZENDUMP_G(enable_compile_profile))
+	{
+		zendump_compile_profile_shutdown();
+	}
+
+	if (ZENDUMP_G(enable_autoload_trace))
+	{
+		zendump_autoload_shutdown();
+	}
+
+	if (ZENDUMP_G(enable_gc_profile))
+	{
+		zendump_gc_profile_shutdown();
+	}
+
+	if (ZENDUMP_G(enable_error_trace))
+	{
+		zendump_error_trace_shutdown();
+	}
+
+	if (ZENDUMP_G(watchdog_threshold) > 0)
+	{
+		zendump_watchdog_shutdown();
+	}
+
+	zendump_preload_shutdown();
+	zendump_receiver_shutdown();
+
+	zendump_unobserve_opcodes();
+
 	UNREGISTER_INI_ENTRIES();
 
 	return SUCCESS;
 }
 /* }}} */
 
-/* Remove if there's nothing to do at request start */
 /* {{{ PHP_RINIT_FUNCTION
  */
 PHP_RINIT_FUNCTION(zendump)
@@ -540,15 +1190,49 @@ PHP_RINIT_FUNCTION(zendump)
 #if defined(COMPILE_DL_ZENDUMP) && defined(ZTS)
 	ZEND_TSRMLS_CACHE_UPDATE();
 #endif
+	ZENDUMP_G(gc_recording) = ZENDUMP_G(enable_gc_profile);
+	ZENDUMP_G(error_recording) = ZENDUMP_G(enable_error_trace);
+
+	if (ZENDUMP_G(watchdog_threshold) > 0)
+	{
+		zendump_watchdog_activate();
+	}
+
 	return SUCCESS;
 }
 /* }}} */
 
-/* Remove if there's nothing to do at request end */
 /* {{{ PHP_RSHUTDOWN_FUNCTION
  */
 PHP_RSHUTDOWN_FUNCTION(zendump)
 {
+	if (ZENDUMP_G(watchdog_threshold) > 0)
+	{
+		zendump_watchdog_deactivate();
+	}
+
+	if (ZENDUMP_G(enable_loop_profile) && ZENDUMP_G(loop_report_limit) > 0)
+	{
+		zendump_hot_loops_dump(ZENDUMP_G(loop_report_limit), 1);
+	}
+
+	if (ZENDUMP_G(enable_preload_trace))
+	{
+		zendump_preload_reset();
+	}
+
+	zendump_cow_reset();
+	zendump_class_layout_reset();
+	zendump_properties_reset();
+	zendump_literal_copy_reset();
+	zendump_profile_reset();
+	ZENDUMP_G(coverage_active) = 0;
+	zendump_compile_profile_reset();
+	zendump_autoload_reset();
+	zendump_gc_profile_reset();
+	zendump_error_trace_reset();
+	zendump_backtrace_reset();
+
 	return SUCCESS;
 }
 /* }}} */
@@ -599,12 +1283,123 @@ ZEND_BEGIN_ARG_INFO(arginfo_zendump_class, 0)
 	ZEND_ARG_INFO(0, column_width)
 ZEND_END_ARG_INFO()
 
+ZEND_BEGIN_ARG_INFO(arginfo_zendump_class_layout, 0)
+	ZEND_ARG_INFO(0, name)
+ZEND_END_ARG_INFO()
+
 ZEND_BEGIN_ARG_INFO(arginfo_zendump_method, 0)
 	ZEND_ARG_INFO(0, class_name)
 	ZEND_ARG_INFO(0, method_name)
 	ZEND_ARG_INFO(0, column_width)
 ZEND_END_ARG_INFO()
 
+ZEND_BEGIN_ARG_INFO(arginfo_zendump_cow_report, 0)
+	ZEND_ARG_INFO(0, limit)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO(arginfo_zendump_objects_survey, 0)
+	ZEND_ARG_INFO(0, limit)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO(arginfo_zendump_string_audit, 0)
+	ZEND_ARG_INFO(0, limit)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO(arginfo_zendump_immutable_audit, 0)
+	ZEND_ARG_INFO(0, min_elements)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO(arginfo_zendump_opcode_mix, 0)
+	ZEND_ARG_INFO(0, limit)
+	ZEND_ARG_INFO(0, column_width)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO(arginfo_zendump_line_profile, 0)
+	ZEND_ARG_INFO(0, callgrind_file)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO(arginfo_zendump_cfg, 0)
+	ZEND_ARG_INFO(0, function)
+	ZEND_ARG_INFO(0, format)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO(arginfo_zendump_hot_loops, 0)
+	ZEND_ARG_INFO(0, limit)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO(arginfo_zendump_coverage_start, 0)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO(arginfo_zendump_coverage_stop, 0)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO(arginfo_zendump_codebase_stats, 0)
+	ZEND_ARG_INFO(0, limit)
+	ZEND_ARG_INFO(0, column_width)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO(arginfo_zendump_compile_profile, 0)
+	ZEND_ARG_INFO(0, limit)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO(arginfo_zendump_autoload_profile, 0)
+	ZEND_ARG_INFO(0, limit)
+	ZEND_ARG_INFO(0, pool)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO(arginfo_zendump_preload_script, 0)
+	ZEND_ARG_INFO(0, filename)
+	ZEND_ARG_INFO(0, min_ratio)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO(arginfo_zendump_runtime_cache, 0)
+	ZEND_ARG_INFO(0, function)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO(arginfo_zendump_receiver_profile, 0)
+	ZEND_ARG_INFO(0, limit)
+	ZEND_ARG_INFO(0, min_classes)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO(arginfo_zendump_type_profile, 0)
+	ZEND_ARG_INFO(0, limit)
+	ZEND_ARG_INFO(0, hintable_only)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO(arginfo_zendump_optimizer_diff, 0)
+	ZEND_ARG_INFO(0, filename)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO(arginfo_zendump_gc_profile, 0)
+	ZEND_ARG_INFO(0, limit)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO(arginfo_zendump_error_profile, 0)
+	ZEND_ARG_INFO(0, limit)
+	ZEND_ARG_INFO(0, pool)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO(arginfo_zendump_backtrace_capture, 0)
+	ZEND_ARG_INFO(0, limit)
+	ZEND_ARG_INFO(0, with_args)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO(arginfo_zendump_backtrace_format, 0)
+	ZEND_ARG_INFO(0, handle)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO(arginfo_zendump_diff, 0)
+	ZEND_ARG_INFO(0, a)
+	ZEND_ARG_INFO(0, b)
+	ZEND_ARG_INFO(0, limit)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO(arginfo_zendump_file, 0)
+	ZEND_ARG_INFO(0, path)
+	ZEND_ARG_INFO(0, output)
+	ZEND_ARG_INFO(0, column_width)
+ZEND_END_ARG_INFO()
+
 /* {{{ zendump_functions[]
  *
  * Every user visible function must have an entry in zendump_functions[].
@@ -619,7 +1414,32 @@ const zend_function_entry zendump_functions[] = {
 	PHP_FE(zendump_opcodes,  arginfo_zendump_opcodes)
 	PHP_FE(zendump_function, arginfo_zendump_function)
 	PHP_FE(zendump_class,    arginfo_zendump_class)
+	PHP_FE(zendump_class_layout, arginfo_zendump_class_layout)
 	PHP_FE(zendump_method,   arginfo_zendump_method)
+	PHP_FE(zendump_cow_report, arginfo_zendump_cow_report)
+	PHP_FE(zendump_objects_survey, arginfo_zendump_objects_survey)
+	PHP_FE(zendump_string_audit, arginfo_zendump_string_audit)
+	PHP_FE(zendump_immutable_audit, arginfo_zendump_immutable_audit)
+	PHP_FE(zendump_opcode_mix, arginfo_zendump_opcode_mix)
+	PHP_FE(zendump_line_profile, arginfo_zendump_line_profile)
+	PHP_FE(zendump_cfg,          arginfo_zendump_cfg)
+	PHP_FE(zendump_hot_loops,    arginfo_zendump_hot_loops)
+	PHP_FE(zendump_coverage_start, arginfo_zendump_coverage_start)
+	PHP_FE(zendump_coverage_stop,  arginfo_zendump_coverage_stop)
+	PHP_FE(zendump_codebase_stats, arginfo_zendump_codebase_stats)
+	PHP_FE(zendump_compile_profile, arginfo_zendump_compile_profile)
+	PHP_FE(zendump_autoload_profile, arginfo_zendump_autoload_profile)
+	PHP_FE(zendump_preload_script, arginfo_zendump_preload_script)
+	PHP_FE(zendump_runtime_cache,  arginfo_zendump_runtime_cache)
+	PHP_FE(zendump_receiver_profile, arginfo_zendump_receiver_profile)
+	PHP_FE(zendump_type_profile,   arginfo_zendump_type_profile)
+	PHP_FE(zendump_optimizer_diff, arginfo_zendump_optimizer_diff)
+	PHP_FE(zendump_file,           arginfo_zendump_file)
+	PHP_FE(zendump_gc_profile,     arginfo_zendump_gc_profile)
+	PHP_FE(zendump_error_profile,  arginfo_zendump_error_profile)
+	PHP_FE(zendump_backtrace_capture, arginfo_zendump_backtrace_capture)
+	PHP_FE(zendump_backtrace_format, arginfo_zendump_backtrace_format)
+	PHP_FE(zendump_diff,           arginfo_zendump_diff)
 	PHP_FE_END /* Must be the last line in zendump_functions[] */
 };
 /* }}} */
@@ -632,8 +1452,8 @@ zend_module_entry zendump_module_entry = {
 	zendump_functions,
 	PHP_MINIT(zendump),
 	PHP_MSHUTDOWN(zendump),
-	NULL, // PHP_RINIT(zendump),		/* Replace with NULL if there's nothing to do at request start */
-	NULL, // PHP_RSHUTDOWN(zendump),	/* Replace with NULL if there's nothing to do at request end */
+	PHP_RINIT(zendump),
+	PHP_RSHUTDOWN(zendump),
 	PHP_MINFO(zendump),
 	PHP_ZENDUMP_VERSION,
 	STANDARD_MODULE_PROPERTIES